@@ -0,0 +1,136 @@
+#include "Game/ActiveChunkMap.hpp"
+
+const uint64_t CHUNK_KEY_HASH_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+
+ActiveChunkMap::ActiveChunkMap()
+	: m_slotBits(0)
+{
+	while ((1 << m_slotBits) < ACTIVE_CHUNK_MAP_INITIAL_CAPACITY)
+		++m_slotBits;
+
+	ChunkSlot emptySlot;
+	emptySlot.m_key = 0;
+	emptySlot.m_chunkIndex = -1;
+	m_slots.assign(1 << m_slotBits, emptySlot);
+}
+
+Chunk* ActiveChunkMap::Find(const IntVector2& chunkCoords) const
+{
+	int slotIndex = FindSlotIndex(PackKey(chunkCoords));
+	if (slotIndex < 0)
+		return nullptr;
+	return m_chunks[m_slots[slotIndex].m_chunkIndex];
+}
+
+void ActiveChunkMap::Insert(const IntVector2& chunkCoords, Chunk* chunk)
+{
+	uint64_t key = PackKey(chunkCoords);
+	int slotIndex = FindSlotIndex(key);
+	if (slotIndex >= 0)
+	{
+		m_chunks[m_slots[slotIndex].m_chunkIndex] = chunk;
+		return;
+	}
+
+	if ((int) (m_chunks.size() + 1) * 2 > (int) m_slots.size())
+		Grow();
+
+	int slotMask = (int) m_slots.size() - 1;
+	slotIndex = GetHomeSlotIndex(key);
+	while (m_slots[slotIndex].m_chunkIndex >= 0)
+		slotIndex = (slotIndex + 1) & slotMask;
+
+	m_slots[slotIndex].m_key = key;
+	m_slots[slotIndex].m_chunkIndex = (int) m_chunks.size();
+	m_chunks.push_back(chunk);
+	m_chunkKeys.push_back(key);
+}
+
+void ActiveChunkMap::Erase(const IntVector2& chunkCoords)
+{
+	int slotIndex = FindSlotIndex(PackKey(chunkCoords));
+	if (slotIndex < 0)
+		return;
+
+	//the last chunk in the list fills the gap so the list stays packed
+	int chunkIndex = m_slots[slotIndex].m_chunkIndex;
+	int lastChunkIndex = (int) m_chunks.size() - 1;
+	if (chunkIndex != lastChunkIndex)
+	{
+		m_chunks[chunkIndex] = m_chunks[lastChunkIndex];
+		m_chunkKeys[chunkIndex] = m_chunkKeys[lastChunkIndex];
+		m_slots[FindSlotIndex(m_chunkKeys[chunkIndex])].m_chunkIndex = chunkIndex;
+	}
+	m_chunks.pop_back();
+	m_chunkKeys.pop_back();
+
+	//later slots of the same probe run shift back into the hole, so lookups never need tombstones
+	int slotMask = (int) m_slots.size() - 1;
+	int holeSlotIndex = slotIndex;
+	int nextSlotIndex = (slotIndex + 1) & slotMask;
+	while (m_slots[nextSlotIndex].m_chunkIndex >= 0)
+	{
+		int homeSlotIndex = GetHomeSlotIndex(m_slots[nextSlotIndex].m_key);
+		if (((nextSlotIndex - homeSlotIndex) & slotMask) >= ((nextSlotIndex - holeSlotIndex) & slotMask))
+		{
+			m_slots[holeSlotIndex] = m_slots[nextSlotIndex];
+			holeSlotIndex = nextSlotIndex;
+		}
+		nextSlotIndex = (nextSlotIndex + 1) & slotMask;
+	}
+	m_slots[holeSlotIndex].m_chunkIndex = -1;
+}
+
+int ActiveChunkMap::GetSize() const
+{
+	return (int) m_chunks.size();
+}
+
+Chunk* ActiveChunkMap::GetChunk(int chunkIndex) const
+{
+	return m_chunks[chunkIndex];
+}
+
+int ActiveChunkMap::FindSlotIndex(uint64_t key) const
+{
+	int slotMask = (int) m_slots.size() - 1;
+	int slotIndex = GetHomeSlotIndex(key);
+	while (m_slots[slotIndex].m_chunkIndex >= 0)
+	{
+		if (m_slots[slotIndex].m_key == key)
+			return slotIndex;
+		slotIndex = (slotIndex + 1) & slotMask;
+	}
+	return -1;
+}
+
+int ActiveChunkMap::GetHomeSlotIndex(uint64_t key) const
+{
+	//neighboring coords differ in few bits, the multiply spreads them over the top bits
+	return (int) ((key * CHUNK_KEY_HASH_MULTIPLIER) >> (64 - m_slotBits));
+}
+
+void ActiveChunkMap::Grow()
+{
+	++m_slotBits;
+	ChunkSlot emptySlot;
+	emptySlot.m_key = 0;
+	emptySlot.m_chunkIndex = -1;
+	m_slots.assign(1 << m_slotBits, emptySlot);
+
+	int slotMask = (int) m_slots.size() - 1;
+	for (int chunkIndex = 0; chunkIndex < (int) m_chunks.size(); ++chunkIndex)
+	{
+		int slotIndex = GetHomeSlotIndex(m_chunkKeys[chunkIndex]);
+		while (m_slots[slotIndex].m_chunkIndex >= 0)
+			slotIndex = (slotIndex + 1) & slotMask;
+
+		m_slots[slotIndex].m_key = m_chunkKeys[chunkIndex];
+		m_slots[slotIndex].m_chunkIndex = chunkIndex;
+	}
+}
+
+uint64_t ActiveChunkMap::PackKey(const IntVector2& chunkCoords)
+{
+	return ((uint64_t) (uint32_t) chunkCoords.x << 32) | (uint64_t) (uint32_t) chunkCoords.y;
+}
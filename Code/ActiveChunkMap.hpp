@@ -0,0 +1,40 @@
+#pragma once
+#include "Engine/Math/IntVector2.hpp"
+#include <vector>
+#include <stdint.h>
+
+class Chunk;
+
+const int ACTIVE_CHUNK_MAP_INITIAL_CAPACITY = 256;
+
+//open addressing hash of chunk coords to active chunks, looking up missing coords never adds them
+//the chunks themselves are kept packed in a list so walking every active chunk skips the empty slots
+class ActiveChunkMap
+{
+public:
+	ActiveChunkMap();
+
+	Chunk* Find(const IntVector2& chunkCoords) const;
+	void Insert(const IntVector2& chunkCoords, Chunk* chunk);
+	void Erase(const IntVector2& chunkCoords);
+	int GetSize() const;
+	Chunk* GetChunk(int chunkIndex) const; //order changes whenever a chunk is erased
+
+private:
+	struct ChunkSlot
+	{
+		uint64_t m_key;
+		int m_chunkIndex; //-1 when the slot is empty
+	};
+
+	int FindSlotIndex(uint64_t key) const;
+	int GetHomeSlotIndex(uint64_t key) const;
+	void Grow();
+
+	static uint64_t PackKey(const IntVector2& chunkCoords);
+
+	std::vector< ChunkSlot > m_slots; //capacity is a power of two and kept at most half full
+	std::vector< Chunk* > m_chunks;
+	std::vector< uint64_t > m_chunkKeys; //key of each chunk in m_chunks, used to find its slot when it is moved
+	int m_slotBits;
+};
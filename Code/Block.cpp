@@ -3,9 +3,9 @@
 
 Block::Block()
 	: m_blockType(0)
+	, m_skyLightLevel(0)
 {
 	m_lightingAndFlags = 0;
-	SetIsSky(false);
 	SetIsOpaque(false);
 	SetIsSolid(false);
 	SetIsLightingDirty(false);
@@ -15,9 +15,9 @@ Block::Block()
 Block::Block(unsigned char blockType, bool isOpaque, bool isSolid)
 {
 	m_blockType = blockType;
+	m_skyLightLevel = 0;
 	m_lightingAndFlags = 0;
 	SetLightLevel(0);
-	SetIsSky(false);
 	SetIsOpaque(isOpaque);
 	SetIsSolid(isSolid);
 	SetIsLightingDirty(false);
@@ -39,31 +39,36 @@ int Block::GetLightLevel() const
 	return m_lightingAndFlags & MASK_LIGHT;
 }
 
-unsigned char Block::GetBlockType() const
+void Block::SetSkyLightLevel(int skyLightLevel)
 {
-	return m_blockType;
+	ASSERT_OR_DIE(skyLightLevel <= MASK_LIGHT, "Sky light level is greater than 15");
+	m_skyLightLevel = (unsigned char) skyLightLevel;
 }
 
-void Block::SetBlockType(unsigned char blockType)
+int Block::GetSkyLightLevel() const
 {
-	m_blockType = blockType;
+	return m_skyLightLevel;
 }
 
-void Block::SetIsSky(bool isSky)
+int Block::GetPackedLight() const
 {
-	if (isSky)
-	{
-		m_lightingAndFlags |= MASK_IS_SKY;		
-	}
-	else
-	{
-		m_lightingAndFlags &= ~MASK_IS_SKY;
-	}
+	return PackLight(GetSkyLightLevel(), GetLightLevel());
 }
 
-bool Block::GetIsSky()
+void Block::SetPackedLight(int packedLight)
 {
-	return (m_lightingAndFlags & MASK_IS_SKY) == MASK_IS_SKY;
+	SetSkyLightLevel(GetSkyLightLevelForPackedLight(packedLight));
+	SetLightLevel(GetLightLevelForPackedLight(packedLight));
+}
+
+unsigned char Block::GetBlockType() const
+{
+	return m_blockType;
+}
+
+void Block::SetBlockType(unsigned char blockType)
+{
+	m_blockType = blockType;
 }
 
 void Block::SetIsOpaque(bool isOpaque)
@@ -78,7 +83,7 @@ void Block::SetIsOpaque(bool isOpaque)
 	}
 }
 
-bool Block::GetIsOpaque()
+bool Block::GetIsOpaque() const
 {
 	return (m_lightingAndFlags & MASK_IS_OPAQUE) == MASK_IS_OPAQUE;
 }
@@ -95,7 +100,7 @@ void Block::SetIsSolid(bool isSolid)
 	}
 }
 
-bool Block::GetIsSolid()
+bool Block::GetIsSolid() const
 {
 	return (m_lightingAndFlags & MASK_IS_SOLID) == MASK_IS_SOLID;
 }
@@ -112,7 +117,45 @@ void Block::SetIsLightingDirty(bool isLightingDirty)
 	}
 }
 
-bool Block::GetIsLightingDirty()
+bool Block::GetIsLightingDirty() const
 {
 	return (m_lightingAndFlags & MASK_IS_LIGHTING_DIRTY) == MASK_IS_LIGHTING_DIRTY;
 }
+
+int Block::PackLight(int skyLightLevel, int lightLevel)
+{
+	return (skyLightLevel << BITS_LIGHT) | lightLevel;
+}
+
+int Block::GetSkyLightLevelForPackedLight(int packedLight)
+{
+	return (packedLight >> BITS_LIGHT) & MASK_LIGHT;
+}
+
+int Block::GetLightLevelForPackedLight(int packedLight)
+{
+	return packedLight & MASK_LIGHT;
+}
+
+int Block::CalcPulledPackedLight(bool isOpaque, bool isSky, int selfIllumination, const int neighborPackedLights[], int numNeighbors)
+{
+	//the one light rule for edits and the parallel solver, a block takes its own glow, the sky, or a neighbor's light minus one
+	//sky light is stored at full strength, the time of day only scales it when faces are drawn
+	int skyLightLevel = 0;
+	int lightLevel = selfIllumination;
+	if (isOpaque)
+		return PackLight(skyLightLevel, lightLevel);
+
+	if (isSky)
+		skyLightLevel = MASK_LIGHT;
+	for (int neighborIndex = 0; neighborIndex < numNeighbors; ++neighborIndex)
+	{
+		int neighborSkyLightLevel = GetSkyLightLevelForPackedLight(neighborPackedLights[neighborIndex]);
+		int neighborLightLevel = GetLightLevelForPackedLight(neighborPackedLights[neighborIndex]);
+		if (neighborSkyLightLevel - 1 > skyLightLevel)
+			skyLightLevel = neighborSkyLightLevel - 1;
+		if (neighborLightLevel - 1 > lightLevel)
+			lightLevel = neighborLightLevel - 1;
+	}
+	return PackLight(skyLightLevel, lightLevel);
+}
@@ -5,8 +5,8 @@
  {
  public:
 	 unsigned char m_blockType;
-	 unsigned char m_lightingAndFlags; //Flags: sky, opaque, solid, dirty lighting
-	 unsigned char m_biomeTemp; 
+	 unsigned char m_lightingAndFlags; //Flags: opaque, solid, dirty lighting
+	 unsigned char m_skyLightLevel; //sky exposure, scaled by the time of day when a face is drawn
 
 	 Block();
 	 Block(unsigned char blockType, bool isOpaque, bool isSolid);
@@ -14,14 +14,21 @@
 
 	 void SetLightLevel(int lightLevel);
 	 int GetLightLevel() const;
+	 void SetSkyLightLevel(int skyLightLevel);
+	 int GetSkyLightLevel() const;
+	 int GetPackedLight() const;
+	 void SetPackedLight(int packedLight);
 	 unsigned char GetBlockType() const;
 	 void SetBlockType(unsigned char blockType); //set flags for that type of block as well
-	 void SetIsSky(bool isSky);
-	 bool GetIsSky();
 	 void SetIsOpaque(bool isOpaque);
-	 bool GetIsOpaque();
+	 bool GetIsOpaque() const;
 	 void SetIsSolid(bool isSolid);
-	 bool GetIsSolid();
+	 bool GetIsSolid() const;
 	 void SetIsLightingDirty(bool isLightingDirty);
-	 bool GetIsLightingDirty();
+	 bool GetIsLightingDirty() const;
+
+	 static int PackLight(int skyLightLevel, int lightLevel);
+	 static int GetSkyLightLevelForPackedLight(int packedLight);
+	 static int GetLightLevelForPackedLight(int packedLight);
+	 static int CalcPulledPackedLight(bool isOpaque, bool isSky, int selfIllumination, const int neighborPackedLights[], int numNeighbors);
  };
\ No newline at end of file
@@ -11,6 +11,9 @@ BlockDefinition::BlockDefinition()
 	, m_isOpaque(false)
 	, m_isSolid(false)
 	, m_selfIllumination(0)
+	, m_tileIndexSides(0)
+	, m_tileIndexZUp(0)
+	, m_tileIndexZDown(0)
 {
 }
 
@@ -25,6 +28,9 @@ BlockDefinition::BlockDefinition(const AABB2D& texCoords, BlockType blockType, b
 	, m_isOpaque(isOpaque)
 	, m_isSolid(isSolid)
 	, m_selfIllumination(selfIllumination)
+	, m_tileIndexSides(0)
+	, m_tileIndexZUp(0)
+	, m_tileIndexZDown(0)
 {
 }
 
@@ -39,6 +45,9 @@ BlockDefinition::BlockDefinition(const Vector2& texCoodsMin, const Vector2& texC
 	, m_isOpaque(isOpaque)
 	, m_isSolid(isSolid)
 	, m_selfIllumination(selfIllumination)
+	, m_tileIndexSides(0)
+	, m_tileIndexZUp(0)
+	, m_tileIndexZDown(0)
 {
 }
 
@@ -53,6 +62,9 @@ BlockDefinition::BlockDefinition(const AABB2D& texCoordsSides, const AABB2D& tex
 	, m_isOpaque(isOpaque)
 	, m_isSolid(isSolid)
 	, m_selfIllumination(selfIllumination)
+	, m_tileIndexSides(0)
+	, m_tileIndexZUp(0)
+	, m_tileIndexZDown(0)
 {
 }
 
@@ -110,6 +122,23 @@ bool BlockDefinition::IsSolid() const
 	return m_isSolid;
 }
 
+void BlockDefinition::SetTileIndexes(unsigned char tileIndexSides, unsigned char tileIndexTop, unsigned char tileIndexBottom)
+{
+	m_tileIndexSides = tileIndexSides;
+	m_tileIndexZUp = tileIndexTop;
+	m_tileIndexZDown = tileIndexBottom;
+}
+
+unsigned char BlockDefinition::GetTileIndexForFace(BlockFace face) const
+{
+	if (face == BLOCK_FACE_UP)
+		return m_tileIndexZUp;
+	else if (face == BLOCK_FACE_DOWN)
+		return m_tileIndexZDown;
+	else
+		return m_tileIndexSides;
+}
+
 char BlockDefinition::GetSelfIllumination() const
 {
 	return m_selfIllumination;
@@ -16,6 +16,17 @@ enum BlockType
 	BLOCK_TYPE_SIZE
 };
 
+enum BlockFace
+{
+	BLOCK_FACE_DOWN,
+	BLOCK_FACE_UP,
+	BLOCK_FACE_NORTH,
+	BLOCK_FACE_SOUTH,
+	BLOCK_FACE_EAST,
+	BLOCK_FACE_WEST,
+	BLOCK_FACE_SIZE
+};
+
 enum BiomeType
 {
 	BIOME_ARCTIC,
@@ -42,6 +53,8 @@ public:
 	AABB2D GetTexCoordsZUp() const;
 	AABB2D GetTexCoordsZDown() const;
 	AABB2D GetTexCoordsSides() const;
+	void SetTileIndexes(unsigned char tileIndexSides, unsigned char tileIndexTop, unsigned char tileIndexBottom);
+	unsigned char GetTileIndexForFace(BlockFace face) const;
 
 	bool IsOpaque() const;
 	bool IsSolid() const;
@@ -58,4 +71,7 @@ private:
 	bool m_isOpaque;
 	bool m_isSolid;
 	char m_selfIllumination; //0 - 15
+	unsigned char m_tileIndexSides; //index into the 16x16 tile atlas
+	unsigned char m_tileIndexZUp;
+	unsigned char m_tileIndexZDown;
 };
\ No newline at end of file
@@ -176,7 +176,7 @@ void BlockInfo::SetBlockInfoFromWorldCoords(const Vector3& worldCoords)
 	}
 
 	IntVector2 chunkCoords = GetChunkCoordsFromWorldPos(worldCoords);
-	m_chunk = g_theGame->m_world->m_activeChunks[chunkCoords];
+	m_chunk = g_theGame->m_world->m_activeChunks.Find(chunkCoords);
 	if (m_chunk == nullptr)
 		return;
 
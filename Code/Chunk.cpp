@@ -5,6 +5,9 @@
 #include "Engine/Math/AABB2D.hpp"
 #include "Engine/Core/Noise.hpp"
 #include "Game/BlockInfo.hpp"
+#include "Game/ChunkVertex.hpp"
+#include "Game/ChunkMeshBuilder.hpp"
+#include "Game/ChunkTileShader.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Game/Game.hpp"
 #include "Game/World.hpp"
@@ -20,98 +23,123 @@ const unsigned int PERLIN_NUM_OCTAVES = 100;
 const float PERLIN_OCTAVE_PERSISTANCE = 0.3f;
 const float PERLIN_OCTAVE_SCALE = 2.f;
 const unsigned int PERLIN_SEED = 24;
-const float LIGHT_LEVEL_DIVISOR = 1.f / 15.f;
 
 Chunk::Chunk()
-	: m_isDirty(false)
 {
-	m_eastNeighbor = nullptr;
-	m_northNeighbor = nullptr;
-	m_westNeighbor = nullptr;
-	m_southNeighbor = nullptr;
-
-	m_vboID = g_theRenderer->CreateVBO();
-	m_numVertexes = 0;
+	//the VBOs live as long as the chunk, every reuse of it from the pool only resets what they hold
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		m_sections[sectionIndex].m_vboID = ChunkTileShader::CreateVertexBuffer();
+	}
 
+	m_spriteSheet = nullptr;
 	for (int blockTypeIndex = 0; blockTypeIndex < BLOCK_TYPE_SIZE; ++blockTypeIndex)
 	{
 		m_blockDefinitions[blockTypeIndex] = nullptr;
 	}
-	m_spriteSheet = nullptr;
-	InitBlocks();
-	InitIsSkyAndDirtyBlocks();
-	GenerateVertexArray();
+	ResetState(IntVector2(0, 0));
 }
 
-Chunk::Chunk(IntVector2 chunkCoords, BlockDefinition* blockDefs[])
+void Chunk::Reset(IntVector2 chunkCoords, BlockDefinition* blockDefs[])
 {
-	m_eastNeighbor = nullptr;
-	m_northNeighbor = nullptr;
-	m_westNeighbor = nullptr;
-	m_southNeighbor = nullptr;
-
-	m_vboID = g_theRenderer->CreateVBO();
-	m_numVertexes = 0;
-
-	m_chunkCoords = chunkCoords;
-	m_worldBounds = AABB3D( Vector3( (float) chunkCoords.x * CHUNK_BLOCKS_WIDE_X, (float) chunkCoords.y * CHUNK_BLOCKS_DEEP_Y, 0.f), 
-							Vector3( (float) chunkCoords.x * CHUNK_BLOCKS_WIDE_X + CHUNK_BLOCKS_WIDE_X, (float) chunkCoords.y * CHUNK_BLOCKS_DEEP_Y + CHUNK_BLOCKS_DEEP_Y, (float) CHUNK_BLOCKS_TALL_Z) );
+	ResetState(chunkCoords);
 	SetBlockDefs(blockDefs);
 	InitBlocks();
-	InitIsSkyAndDirtyBlocks();
-	GenerateVertexArray();
+	UpdateAllSectionFlags();
+	InitSkyHeights();
 }
 
-Chunk::Chunk(IntVector2 chunkCoords, BlockDefinition* blockDefs[], const std::vector< unsigned char > chunkData)
+void Chunk::Reset(IntVector2 chunkCoords, BlockDefinition* blockDefs[], const std::vector< unsigned char >& chunkData)
 {
-	m_eastNeighbor = nullptr;
-	m_northNeighbor = nullptr;
-	m_westNeighbor = nullptr;
-	m_southNeighbor = nullptr;
-
-	m_vboID = g_theRenderer->CreateVBO();
-	m_numVertexes = 0;
-
-	m_chunkCoords = chunkCoords;
-	m_worldBounds = AABB3D(	Vector3((float)chunkCoords.x * CHUNK_BLOCKS_WIDE_X, (float)chunkCoords.y * CHUNK_BLOCKS_DEEP_Y, 0.f),
-							Vector3((float)chunkCoords.x * CHUNK_BLOCKS_WIDE_X + CHUNK_BLOCKS_WIDE_X, (float)chunkCoords.y * CHUNK_BLOCKS_DEEP_Y + CHUNK_BLOCKS_DEEP_Y, (float)CHUNK_BLOCKS_TALL_Z));
+	ResetState(chunkCoords);
 	SetBlockDefs(blockDefs);
 
-	std::vector< unsigned char >::const_iterator iter;
-	iter = chunkData.begin();
-
-	++iter;
-	if ( *iter != CHUNK_BLOCKS_WIDE_X)
-		return;
-	++iter;
-	if (*iter != CHUNK_BLOCKS_DEEP_Y)
-		return;
-	++iter;
-	if (*iter != CHUNK_BLOCKS_TALL_Z)
+	if ((int) chunkData.size() < CHUNK_FILE_HEADER_SIZE || chunkData[1] != CHUNK_BLOCKS_WIDE_X || chunkData[2] != CHUNK_BLOCKS_DEEP_Y || chunkData[3] != CHUNK_BLOCKS_TALL_Z)
+	{
+		//unreadable files come back as air, the same as a chunk that was never filled
+		for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+		{
+			m_blocks[blockIndex] = Block();
+		}
+		UpdateAllSectionFlags();
+		InitSkyHeights();
 		return;
+	}
 
-	++iter;
+	//block type runs fill the chunk exactly, anything after them is the saved light
+	int readIndex = CHUNK_FILE_HEADER_SIZE;
 	int blockIndex = 0;
-	for (iter; iter != chunkData.end(); ++iter)
+	while (blockIndex < NUM_BLOCKS_PER_CHUNK && readIndex + 1 < (int) chunkData.size())
 	{
-		unsigned char blockType = *iter;
-		++iter;
-		unsigned char loopCount = *iter;
+		unsigned char blockType = chunkData[readIndex];
+		unsigned char loopCount = chunkData[readIndex + 1];
+		readIndex += 2;
 
-		for (int loopBlockIndex = 0; loopBlockIndex < loopCount; ++loopBlockIndex)
+		for (int loopBlockIndex = 0; loopBlockIndex < loopCount && blockIndex < NUM_BLOCKS_PER_CHUNK; ++loopBlockIndex)
 		{
 			m_blocks[blockIndex] = Block(blockType, m_blockDefinitions[blockType]->IsOpaque(), m_blockDefinitions[blockType]->IsSolid() );
 			++blockIndex;
 		}
 	}
 
-	InitIsSkyAndDirtyBlocks();
-	GenerateVertexArray();
+	if (chunkData[0] != CHUNK_FILE_VERSION_WITHOUT_LIGHT && blockIndex == NUM_BLOCKS_PER_CHUNK)
+		m_hasSavedLight = ReadRLELightData(chunkData, readIndex, CHUNK_FILE_HEADER_SIZE);
+
+	UpdateAllSectionFlags();
+	InitSkyHeights();
 }
 
 Chunk::~Chunk()
 {
-	g_theRenderer->DestroyVBO(m_vboID);
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		ChunkTileShader::DestroyVertexBuffer(m_sections[sectionIndex].m_vboID);
+	}
+}
+
+void Chunk::ResetState(IntVector2 chunkCoords)
+{
+	m_eastNeighbor = nullptr;
+	m_northNeighbor = nullptr;
+	m_westNeighbor = nullptr;
+	m_southNeighbor = nullptr;
+
+	InitSections();
+	m_lod = CHUNK_LOD_FULL;
+	m_isVisible = true;
+	m_isQueuedForRemesh = false;
+	m_numDirtyLightingBlocks = 0;
+	m_slotIndex = -1;
+	m_hasCachedMesh = false;
+	m_hasSavedLight = false;
+	m_state = CHUNK_STATE_GENERATED;
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		m_pendingBorderLight[borderIndex].clear();
+	}
+
+	m_chunkCoords = chunkCoords;
+	m_worldBounds = AABB3D( Vector3( (float) chunkCoords.x * CHUNK_BLOCKS_WIDE_X, (float) chunkCoords.y * CHUNK_BLOCKS_DEEP_Y, 0.f), 
+							Vector3( (float) chunkCoords.x * CHUNK_BLOCKS_WIDE_X + CHUNK_BLOCKS_WIDE_X, (float) chunkCoords.y * CHUNK_BLOCKS_DEEP_Y + CHUNK_BLOCKS_DEEP_Y, (float) CHUNK_BLOCKS_TALL_Z) );
+}
+
+void Chunk::InitSections()
+{
+	//vertex vectors keep their capacity, the next mesh of a reused chunk fills them again
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		ChunkSection& section = m_sections[sectionIndex];
+		section.m_vertexes.clear();
+		section.m_numVertexes = 0;
+		section.m_numIndexes = 0;
+		section.m_latestMeshJobID = 0;
+		section.m_appliedMeshJobID = 0;
+		section.m_isDirty = true;
+		section.m_isLightDirty = false;
+		section.m_canRecolor = false;
+		section.m_isAllAir = true;
+		section.m_isAllOpaque = false;
+	}
 }
 
 void Chunk::InitBlocks()
@@ -198,37 +226,69 @@ void Chunk::InitBlocks()
 	}
 }
 
-void Chunk::InitIsSkyAndDirtyBlocks()
+void Chunk::InitSkyHeights()
 {
+	//light is flooded by the world once the heights are known, light across the borders is reconciled when neighbors link
 	for (int blockIndexY = 0; blockIndexY < CHUNK_BLOCKS_DEEP_Y; ++blockIndexY)
 	{
 		for (int blockIndexX = 0; blockIndexX < CHUNK_BLOCKS_WIDE_X; ++blockIndexX)
 		{
-			bool isSettingOpaqueToSky = true;
+			int columnIndex = GetColumnIndexForBlockIndex(GetBlockIndexForBlockCoords(IntVector3(blockIndexX, blockIndexY, 0)));
+			m_skyHeights[columnIndex] = 0;
 			for (int blockIndexZ = CHUNK_BLOCKS_TALL_Z - 1; blockIndexZ >= 0; --blockIndexZ)
 			{
-				int blockIndex = GetBlockIndexForBlockCoords(IntVector3(blockIndexX, blockIndexY, blockIndexZ));
-
-				if (m_blocks[blockIndex].GetBlockType() == (unsigned char) BLOCK_TYPE_AIR)
+				//skip whole sections that cannot hold the top block of the column
+				if ((blockIndexZ & (CHUNK_SECTION_BLOCKS_TALL_Z - 1)) == CHUNK_SECTION_BLOCKS_TALL_Z - 1)
 				{
-					if (isSettingOpaqueToSky)
-						m_blocks[blockIndex].SetIsSky(true);
-					if (isSettingOpaqueToSky || blockIndexX == 0 || blockIndexX == CHUNK_BLOCKS_WIDE_X - 1 || blockIndexY == 0 || blockIndexY == CHUNK_BLOCKS_DEEP_Y - 1 || blockIndexZ == 0 || blockIndexZ == CHUNK_BLOCKS_TALL_Z - 1)
+					int sectionIndex = blockIndexZ >> CHUNK_BITS_SECTION_Z;
+					if (m_sections[sectionIndex].m_isAllOpaque)
+					{
+						m_skyHeights[columnIndex] = (unsigned char) (blockIndexZ + 1);
+						break;
+					}
+					if (m_sections[sectionIndex].m_isAllAir)
 					{
-						m_blocks[blockIndex].SetIsLightingDirty(true);
-						if (g_theGame != nullptr)
-							g_theGame->m_world->m_dirtyLightingBlocks.push_back( new BlockInfo(this, blockIndex) );
+						blockIndexZ -= CHUNK_SECTION_BLOCKS_TALL_Z - 1;
+						continue;
 					}
 				}
-				else
+
+				int blockIndex = GetBlockIndexForBlockCoords(IntVector3(blockIndexX, blockIndexY, blockIndexZ));
+				if (m_blocks[blockIndex].GetBlockType() != (unsigned char) BLOCK_TYPE_AIR)
 				{
-					isSettingOpaqueToSky = false;
+					m_skyHeights[columnIndex] = (unsigned char) (blockIndexZ + 1);
+					break;
 				}
 			}
 		}
 	}
 }
 
+void Chunk::UpdateSectionFlags(int sectionIndex)
+{
+	int numAirBlocks = 0;
+	int numOpaqueBlocks = 0;
+	int firstBlockIndex = sectionIndex * NUM_BLOCKS_PER_SECTION;
+	for (int blockIndex = firstBlockIndex; blockIndex < firstBlockIndex + NUM_BLOCKS_PER_SECTION; ++blockIndex)
+	{
+		if (m_blocks[blockIndex].m_blockType == BLOCK_TYPE_AIR)
+			++numAirBlocks;
+		if (m_blocks[blockIndex].GetIsOpaque())
+			++numOpaqueBlocks;
+	}
+
+	m_sections[sectionIndex].m_isAllAir = numAirBlocks == NUM_BLOCKS_PER_SECTION;
+	m_sections[sectionIndex].m_isAllOpaque = numOpaqueBlocks == NUM_BLOCKS_PER_SECTION;
+}
+
+void Chunk::UpdateAllSectionFlags()
+{
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		UpdateSectionFlags(sectionIndex);
+	}
+}
+
 void Chunk::Render() const
 {
 	RenderBlocks();
@@ -241,7 +301,12 @@ void Chunk::RenderBlocks() const
 
 	g_theRenderer->PushMatrix();
 	g_theRenderer->Translate(m_worldBounds.mins.x, m_worldBounds.mins.y);
-	g_theRenderer->DrawVBO3D_PCT(m_vboID, m_numVertexes, PRIMITIVE_QUADS);
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		const ChunkSection& section = m_sections[sectionIndex];
+		if (section.m_numIndexes > 0)
+			ChunkTileShader::DrawVertexBuffer(section.m_vboID, section.m_numIndexes);
+	}
 // 	if ((int) m_vertexArray.size() > 0)
 // 		g_theRenderer->DrawVertexArray3D_PCT(&m_vertexArray[0], (int) m_vertexArray.size(), PRIMITIVE_QUADS); 
 	g_theRenderer->PopMatrix();
@@ -275,137 +340,213 @@ Vector3 Chunk::GetChunkCenterWorldCoords()
 	return m_worldBounds.CalcCenter() + m_worldBounds.mins;
 }
 
-void Chunk::GenerateVertexArray()
+void Chunk::CreateMeshInput(ChunkMeshInput& meshInput, int meshJobID)
 {
-	std::vector< Vertex3_PCT >	vertexArray;
-	vertexArray.resize(CHUNK_BLOCKS_WIDE_X * CHUNK_BLOCKS_DEEP_Y * 40 );
+	CopyToMeshInput(meshInput);
+	meshInput.m_meshJobID = meshJobID;
+	meshInput.m_dirtySectionMask = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		ChunkSection& section = m_sections[sectionIndex];
+		if (section.m_isDirty)
+		{
+			meshInput.m_dirtySectionMask |= 1 << sectionIndex;
+			section.m_latestMeshJobID = meshJobID;
+			section.m_isDirty = false;
+			section.m_isLightDirty = false;
+		}
+	}
+}
 
-	for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+void Chunk::CopyToMeshInput(ChunkMeshInput& meshInput) const
+{
+	meshInput.m_chunkCoords = m_chunkCoords;
+	meshInput.m_meshJobID = 0;
+	meshInput.m_isGreedyMeshing = g_isGreedyMeshing;
+	meshInput.m_isMaskCulling = g_isMaskCulling;
+	meshInput.m_lod = m_lod;
+	meshInput.m_blockDefinitions = m_blockDefinitions;
+	meshInput.m_dirtySectionMask = (1 << NUM_SECTIONS_PER_CHUNK) - 1;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
 	{
-		IntVector3 blockCoords = GetBlockCoordsForBlockIndex(blockIndex);
-		int blockIndexX = blockCoords.x;
-		int blockIndexY = blockCoords.y;
-		int blockIndexZ = blockCoords.z;
+		const ChunkSection& section = m_sections[sectionIndex];
+		meshInput.m_previousNumVertexes[sectionIndex] = section.m_numVertexes;
+		meshInput.m_isSectionAllAir[sectionIndex] = section.m_isAllAir;
+		meshInput.m_isSectionAllOpaque[sectionIndex] = section.m_isAllOpaque;
+
+		//a missing neighbor hides the faces against it just like a solid one would
+		meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_NORTH][sectionIndex] = m_northNeighbor == nullptr || m_northNeighbor->m_sections[sectionIndex].m_isAllOpaque;
+		meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_SOUTH][sectionIndex] = m_southNeighbor == nullptr || m_southNeighbor->m_sections[sectionIndex].m_isAllOpaque;
+		meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_EAST][sectionIndex] = m_eastNeighbor == nullptr || m_eastNeighbor->m_sections[sectionIndex].m_isAllOpaque;
+		meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_WEST][sectionIndex] = m_westNeighbor == nullptr || m_westNeighbor->m_sections[sectionIndex].m_isAllOpaque;
+	}
 
-		BlockInfo blockInfo(this, blockIndex);
-		BlockInfo neighbor;
-		RGBA faceColor;
+	//the padding is open sky above and below the world and opaque where a neighbor chunk is not loaded
+	Block skyPadding;
+	skyPadding.SetSkyLightLevel(MASK_LIGHT);
+	Block missingNeighborPadding(BLOCK_TYPE_STONE, true, true);
+	for (int paddedIndex = 0; paddedIndex < NUM_PADDED_BLOCKS; ++paddedIndex)
+	{
+		meshInput.m_paddedBlocks[paddedIndex] = missingNeighborPadding;
+	}
+	for (int paddedIndex = 0; paddedIndex < PADDED_BLOCKS_PER_LAYER; ++paddedIndex)
+	{
+		meshInput.m_paddedBlocks[paddedIndex] = skyPadding;
+		meshInput.m_paddedBlocks[NUM_PADDED_BLOCKS - PADDED_BLOCKS_PER_LAYER + paddedIndex] = skyPadding;
+	}
 
-		if (m_blocks[blockIndex].m_blockType != BLOCK_TYPE_AIR)
+	for (int blockIndexZ = 0; blockIndexZ < CHUNK_BLOCKS_TALL_Z; ++blockIndexZ)
+	{
+		for (int blockIndexY = 0; blockIndexY < CHUNK_BLOCKS_DEEP_Y; ++blockIndexY)
 		{
-			AABB2D texBoundsSides = m_blockDefinitions[m_blocks[blockIndex].m_blockType]->GetTexCoordsXForward();
-			AABB2D texBoundsZUp = m_blockDefinitions[m_blocks[blockIndex].m_blockType]->GetTexCoordsZUp();
-			AABB2D texBoundsZDown = m_blockDefinitions[m_blocks[blockIndex].m_blockType]->GetTexCoordsZDown();
-
-			//down
-			neighbor = blockInfo.GetBelowNeighbor();
-			if (blockIndexZ == 0 || (neighbor.m_chunk != nullptr && neighbor.GetBlock()->GetIsOpaque() == false) )
+			//rows are contiguous in both layouts
+			int blockIndex = GetBlockIndexForBlockCoords(IntVector3(0, blockIndexY, blockIndexZ));
+			int paddedIndex = ChunkMeshBuilder::GetPaddedIndexForBlockCoords(IntVector3(0, blockIndexY, blockIndexZ));
+			for (int blockIndexX = 0; blockIndexX < CHUNK_BLOCKS_WIDE_X; ++blockIndexX)
 			{
-				if (blockIndexZ != 0)
-				{
-					float grayScale = (float)neighbor.GetBlock()->GetLightLevel() * LIGHT_LEVEL_DIVISOR;
-					faceColor = RGBA(grayScale, grayScale, grayScale, 1.f);
-				}
-				else
-					faceColor = RGBA::WHITE;
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY,		blockIndexZ),		faceColor, Vector2(texBoundsZDown.maxs.x, texBoundsZDown.mins.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY + 1,	blockIndexZ),		faceColor, texBoundsZDown.maxs));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1, blockIndexY + 1,	blockIndexZ),		faceColor, Vector2(texBoundsZDown.mins.x, texBoundsZDown.maxs.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1, blockIndexY,		blockIndexZ),		faceColor, texBoundsZDown.mins));	
+				meshInput.m_paddedBlocks[paddedIndex + blockIndexX] = m_blocks[blockIndex + blockIndexX];
 			}
 
-			//up
-			neighbor = blockInfo.GetAboveNeighbor();
-			if (blockIndexZ == CHUNK_BLOCKS_TALL_Z - 1 || (neighbor.m_chunk != nullptr && neighbor.GetBlock()->GetIsOpaque() == false))
-			{
-				if (blockIndexZ != CHUNK_BLOCKS_TALL_Z - 1)
-				{
-					float grayScale = (float) neighbor.GetBlock()->GetLightLevel() * LIGHT_LEVEL_DIVISOR;
-					faceColor = RGBA(grayScale, grayScale, grayScale, 1.f);
-				}
-				else
-					faceColor = RGBA::WHITE;
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY,		blockIndexZ + 1),	faceColor, texBoundsZUp.maxs));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY,		blockIndexZ + 1),	faceColor, Vector2(texBoundsZUp.maxs.x, texBoundsZUp.mins.y)));		 
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY + 1,	blockIndexZ + 1),	faceColor, texBoundsZUp.mins));		 
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY + 1,	blockIndexZ + 1),	faceColor, Vector2(texBoundsZUp.mins.x, texBoundsZUp.maxs.y)));
-			}
-															  			
-			//north
-			neighbor = blockInfo.GetNorthNeighbor();
-			if (neighbor.m_chunk != nullptr && neighbor.GetBlock()->GetIsOpaque() == false) //blockIndexY == CHUNK_BLOCKS_DEEP_Y - 1 || 
-			{
-// 				if (blockIndexY != CHUNK_BLOCKS_DEEP_Y - 1)
-// 				{
-					float grayScale = (float)neighbor.GetBlock()->GetLightLevel() * LIGHT_LEVEL_DIVISOR;
-					faceColor = RGBA(grayScale, grayScale, grayScale, 1.f);
-// 				}
-// 				else
-// 					faceColor = RGBA::WHITE;
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY + 1,	blockIndexZ),		faceColor, Vector2(texBoundsSides.mins.x, texBoundsSides.maxs.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY + 1,	blockIndexZ + 1),	faceColor, texBoundsSides.mins));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1, blockIndexY + 1,	blockIndexZ + 1),	faceColor, Vector2(texBoundsSides.maxs.x, texBoundsSides.mins.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1, blockIndexY + 1,	blockIndexZ),		faceColor, texBoundsSides.maxs));
-			}
-							
-			//south
-			neighbor = blockInfo.GetSouthNeighbor();
-			if ( neighbor.m_chunk != nullptr && neighbor.GetBlock()->GetIsOpaque() == false) //blockIndexY == 0 ||
-			{
-// 				if (blockIndexY != 0)
-// 				{
-					float grayScale = (float)neighbor.GetBlock()->GetLightLevel() * LIGHT_LEVEL_DIVISOR;
-					faceColor = RGBA(grayScale, grayScale, grayScale, 1.f);
-// 				}
-// 				else
-// 					faceColor = RGBA::WHITE;
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY,		blockIndexZ),		faceColor, Vector2(texBoundsSides.mins.x, texBoundsSides.maxs.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY,		blockIndexZ),		faceColor, texBoundsSides.maxs));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY,		blockIndexZ + 1),	faceColor, Vector2(texBoundsSides.maxs.x, texBoundsSides.mins.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY,		blockIndexZ + 1),	faceColor, texBoundsSides.mins));
-			}
-							
-			//east
-			neighbor = blockInfo.GetEastNeighbor();
-			if ( neighbor.m_chunk != nullptr && neighbor.GetBlock()->GetIsOpaque() == false) //blockIndexX == CHUNK_BLOCKS_WIDE_X - 1 ||
+			if (m_eastNeighbor != nullptr)
+				meshInput.m_paddedBlocks[paddedIndex + CHUNK_BLOCKS_WIDE_X] = m_eastNeighbor->m_blocks[blockIndex];
+			if (m_westNeighbor != nullptr)
+				meshInput.m_paddedBlocks[paddedIndex - 1] = m_westNeighbor->m_blocks[blockIndex + CHUNK_BLOCKS_WIDE_X - 1];
+		}
+
+		for (int blockIndexX = 0; blockIndexX < CHUNK_BLOCKS_WIDE_X; ++blockIndexX)
+		{
+			if (m_northNeighbor != nullptr)
 			{
-// 				if (blockIndexX != CHUNK_BLOCKS_WIDE_X - 1)
-// 				{
-					float grayScale = (float)neighbor.GetBlock()->GetLightLevel() * LIGHT_LEVEL_DIVISOR;
-					faceColor = RGBA(grayScale, grayScale, grayScale, 1.f);
-// 				}
-// 				else
-// 					faceColor = RGBA::WHITE;
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY,		blockIndexZ),		faceColor, texBoundsSides.maxs));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY + 1,	blockIndexZ),		faceColor, Vector2(texBoundsSides.mins.x, texBoundsSides.maxs.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY + 1,	blockIndexZ + 1),	faceColor, texBoundsSides.mins));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX + 1,	blockIndexY,		blockIndexZ + 1),	faceColor, Vector2(texBoundsSides.maxs.x, texBoundsSides.mins.y)));
+				int paddedIndex = ChunkMeshBuilder::GetPaddedIndexForBlockCoords(IntVector3(blockIndexX, CHUNK_BLOCKS_DEEP_Y, blockIndexZ));
+				meshInput.m_paddedBlocks[paddedIndex] = m_northNeighbor->m_blocks[GetBlockIndexForBlockCoords(IntVector3(blockIndexX, 0, blockIndexZ))];
 			}
-							
-			//west
-			neighbor = blockInfo.GetWestNeighbor();
-			if ( neighbor.m_chunk != nullptr && neighbor.GetBlock()->GetIsOpaque() == false) //blockIndexX == 0 ||
+			if (m_southNeighbor != nullptr)
 			{
-// 				if (blockIndexX != 0)
-// 				{
-					float grayScale = (float)neighbor.GetBlock()->GetLightLevel() * LIGHT_LEVEL_DIVISOR;
-					faceColor = RGBA(grayScale, grayScale, grayScale, 1.f);
-// 				}
-// 				else
-// 					faceColor = RGBA::WHITE;
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY,		blockIndexZ),		faceColor, texBoundsSides.maxs));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY,		blockIndexZ + 1),	faceColor, Vector2(texBoundsSides.maxs.x, texBoundsSides.mins.y)));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY + 1,	blockIndexZ + 1),	faceColor, texBoundsSides.mins));
-				vertexArray.push_back(Vertex3_PCT(IntVector3(blockIndexX,		blockIndexY + 1,	blockIndexZ),		faceColor, Vector2(texBoundsSides.mins.x, texBoundsSides.maxs.y)));
+				int paddedIndex = ChunkMeshBuilder::GetPaddedIndexForBlockCoords(IntVector3(blockIndexX, -1, blockIndexZ));
+				meshInput.m_paddedBlocks[paddedIndex] = m_southNeighbor->m_blocks[GetBlockIndexForBlockCoords(IntVector3(blockIndexX, CHUNK_BLOCKS_DEEP_Y - 1, blockIndexZ))];
 			}
 		}
 	}
+}
+
+int Chunk::ApplyMeshResult(ChunkMeshResult& meshResult)
+{
+	int numBytesUploaded = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		//sections remeshed again since this job was queued wait for the newer result
+		ChunkSection& section = m_sections[sectionIndex];
+		if ((meshResult.m_sectionMask & (1 << sectionIndex)) == 0 || section.m_latestMeshJobID != meshResult.m_meshJobID)
+			continue;
+
+		//the section keeps the new geometry and hands its old storage back to the result for reuse
+		section.m_vertexes.swap(meshResult.m_sectionVertexes[sectionIndex]);
+		section.m_appliedMeshJobID = meshResult.m_meshJobID;
+		section.m_canRecolor = meshResult.m_isRecolorable;
+		section.m_numVertexes = (int) section.m_vertexes.size();
+		section.m_numIndexes = ChunkVertex::CalcNumIndexesForVertexes(section.m_numVertexes);
+		ASSERT_OR_DIE(section.m_numIndexes <= MAX_INDEXES_PER_SECTION, "Section mesh has more quads than the quad index buffer covers");
+		if (section.m_numVertexes > 0)
+			ChunkTileShader::UpdateVertexBuffer(section.m_vboID, &section.m_vertexes[0], section.m_numVertexes);
+		numBytesUploaded += section.m_numVertexes * (int) sizeof(ChunkVertex);
+	}
+	return numBytesUploaded;
+}
+
+int Chunk::RecolorLightDirtySections(int maxBytesToUpload)
+{
+	int numBytesUploaded = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK && numBytesUploaded < maxBytesToUpload; ++sectionIndex)
+	{
+		//a section with a mesh job in flight waits for it, the result may carry older light
+		ChunkSection& section = m_sections[sectionIndex];
+		if (!section.m_isLightDirty || section.m_isDirty || section.m_latestMeshJobID != section.m_appliedMeshJobID)
+			continue;
+
+		RecolorSection(sectionIndex);
+		if (section.m_numVertexes > 0)
+			ChunkTileShader::UpdateVertexBuffer(section.m_vboID, &section.m_vertexes[0], section.m_numVertexes);
+		numBytesUploaded += section.m_numVertexes * (int) sizeof(ChunkVertex);
+		section.m_isLightDirty = false;
+	}
+	return numBytesUploaded;
+}
+
+void Chunk::RecolorSection(int sectionIndex)
+{
+	//geometry stays as is, only the light bits of each quad are recomputed from the block across its face
+	std::vector< ChunkVertex >& vertexes = m_sections[sectionIndex].m_vertexes;
+	for (int vertexIndex = 0; vertexIndex < (int) vertexes.size(); vertexIndex += NUM_VERTEXES_PER_QUAD)
+	{
+		int packedLight = CalcQuadPackedLight(&vertexes[vertexIndex]);
+		for (int cornerIndex = 0; cornerIndex < NUM_VERTEXES_PER_QUAD; ++cornerIndex)
+		{
+			vertexes[vertexIndex + cornerIndex].SetPackedLight(packedLight);
+		}
+	}
+}
+
+int Chunk::CalcQuadPackedLight(const ChunkVertex* quadVertexes) const
+{
+	//the lowest corner of a single block face is the block across it for up, north and east faces
+	IntVector3 lightCoords = quadVertexes[0].GetLocalPosition();
+	for (int cornerIndex = 1; cornerIndex < NUM_VERTEXES_PER_QUAD; ++cornerIndex)
+	{
+		IntVector3 cornerCoords = quadVertexes[cornerIndex].GetLocalPosition();
+		if (cornerCoords.x < lightCoords.x)
+			lightCoords.x = cornerCoords.x;
+		if (cornerCoords.y < lightCoords.y)
+			lightCoords.y = cornerCoords.y;
+		if (cornerCoords.z < lightCoords.z)
+			lightCoords.z = cornerCoords.z;
+	}
+
+	BlockFace face = quadVertexes[0].GetFace();
+	if (face == BLOCK_FACE_DOWN)
+		--lightCoords.z;
+	else if (face == BLOCK_FACE_SOUTH)
+		--lightCoords.y;
+	else if (face == BLOCK_FACE_WEST)
+		--lightCoords.x;
+
+	int packedLight = GetPackedLightAtLocalCoords(lightCoords);
+	if (packedLight < 0)
+		return quadVertexes[0].GetPackedLight();
+	return packedLight;
+}
 
-	m_isDirty = false;
+int Chunk::GetPackedLightAtLocalCoords(const IntVector3& blockCoords) const
+{
+	//outside the world is open sky, an unloaded neighbor returns -1 so the face keeps its light
+	if (blockCoords.z < 0 || blockCoords.z >= CHUNK_BLOCKS_TALL_Z)
+		return Block::PackLight(MASK_LIGHT, 0);
+
+	const Chunk* chunk = this;
+	IntVector3 localCoords = blockCoords;
+	if (localCoords.x < 0)
+	{
+		chunk = m_westNeighbor;
+		localCoords.x += CHUNK_BLOCKS_WIDE_X;
+	}
+	else if (localCoords.x >= CHUNK_BLOCKS_WIDE_X)
+	{
+		chunk = m_eastNeighbor;
+		localCoords.x -= CHUNK_BLOCKS_WIDE_X;
+	}
+	else if (localCoords.y < 0)
+	{
+		chunk = m_southNeighbor;
+		localCoords.y += CHUNK_BLOCKS_DEEP_Y;
+	}
+	else if (localCoords.y >= CHUNK_BLOCKS_DEEP_Y)
+	{
+		chunk = m_northNeighbor;
+		localCoords.y -= CHUNK_BLOCKS_DEEP_Y;
+	}
 
-	m_numVertexes = (int) vertexArray.size();
-	g_theRenderer->UpdateVBO(m_vboID, &vertexArray[0], m_numVertexes);
-	vertexArray.clear();
+	if (chunk == nullptr)
+		return -1;
+	return chunk->m_blocks[GetBlockIndexForBlockCoords(localCoords)].GetPackedLight();
 }
 
 void Chunk::SetFrustumCulling(const Vector3& cameraForwardXYZ, const Vector3& cameraPos)
@@ -423,6 +564,11 @@ void Chunk::SetFrustumCulling(const Vector3& cameraForwardXYZ, const Vector3& ca
 	}
 }
 
+bool Chunk::IsVisible() const
+{
+	return m_isVisible;
+}
+
 Vector3 Chunk::GetCornerWorldPosFromIndex(int cornerIndex)
 {
 	if (cornerIndex == 0)
@@ -445,15 +591,71 @@ Vector3 Chunk::GetCornerWorldPosFromIndex(int cornerIndex)
 
 bool Chunk::IsChunkDirty()
 {
-	return m_isDirty;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		if (m_sections[sectionIndex].m_isDirty)
+			return true;
+	}
+	return false;
+}
+
+bool Chunk::IsLightDirty() const
+{
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		if (m_sections[sectionIndex].m_isLightDirty)
+			return true;
+	}
+	return false;
+}
+
+int Chunk::GetNumVertexes() const
+{
+	int numVertexes = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		numVertexes += m_sections[sectionIndex].m_numVertexes;
+	}
+	return numVertexes;
+}
+
+int Chunk::GetNumIndexes() const
+{
+	int numIndexes = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		numIndexes += m_sections[sectionIndex].m_numIndexes;
+	}
+	return numIndexes;
+}
+
+int Chunk::CalcNumPackedVertexBytes() const
+{
+	//capacity, not size, the storage is kept between remeshes
+	int numBytes = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		numBytes += (int) m_sections[sectionIndex].m_vertexes.capacity() * (int) sizeof(ChunkVertex);
+	}
+	return numBytes;
+}
+
+int Chunk::CalcNumVBOBytes() const
+{
+	int numBytes = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		numBytes += m_sections[sectionIndex].m_numVertexes * (int) sizeof(ChunkVertex);
+	}
+	return numBytes;
 }
 
-int Chunk::GetBlockIndexForBlockCoords(const IntVector3& blockCoords) const
+int Chunk::GetBlockIndexForBlockCoords(const IntVector3& blockCoords)
 {
 	return blockCoords.x | (blockCoords.y << CHUNK_BITS_Y) | (blockCoords.z << CHUNK_BITS_XY);
 }
 
-IntVector3 Chunk::GetBlockCoordsForBlockIndex(int blockIndex) const
+IntVector3 Chunk::GetBlockCoordsForBlockIndex(int blockIndex)
 {
 	IntVector3 blockCoords;
 	blockCoords.x = blockIndex & MASK_X;
@@ -462,38 +664,341 @@ IntVector3 Chunk::GetBlockCoordsForBlockIndex(int blockIndex) const
 	return blockCoords;
 }
 
+int Chunk::GetSectionIndexForBlockIndex(int blockIndex)
+{
+	return blockIndex >> (CHUNK_BITS_XY + CHUNK_BITS_SECTION_Z);
+}
+
+int Chunk::GetColumnIndexForBlockIndex(int blockIndex)
+{
+	return blockIndex & (CHUNK_BLOCKS_PER_LAYER - 1);
+}
+
+int Chunk::GetBlockIndexForBorderIndex(LightingBorder border, int borderIndex)
+{
+	//east and west borders run along y, north and south along x, with the same order on both sides of a shared face
+	int blockIndexU = borderIndex & (CHUNK_BLOCKS_WIDE_X - 1);
+	int blockIndexZ = borderIndex >> CHUNK_BITS_X;
+	IntVector3 blockCoords(blockIndexU, blockIndexU, blockIndexZ);
+	if (border == LIGHTING_BORDER_EAST)
+		blockCoords.x = CHUNK_BLOCKS_WIDE_X - 1;
+	else if (border == LIGHTING_BORDER_WEST)
+		blockCoords.x = 0;
+	else if (border == LIGHTING_BORDER_NORTH)
+		blockCoords.y = CHUNK_BLOCKS_DEEP_Y - 1;
+	else
+		blockCoords.y = 0;
+	return GetBlockIndexForBlockCoords(blockCoords);
+}
+
+LightingBorder Chunk::GetOppositeBorder(LightingBorder border)
+{
+	if (border == LIGHTING_BORDER_EAST)
+		return LIGHTING_BORDER_WEST;
+	if (border == LIGHTING_BORDER_WEST)
+		return LIGHTING_BORDER_EAST;
+	if (border == LIGHTING_BORDER_NORTH)
+		return LIGHTING_BORDER_SOUTH;
+	return LIGHTING_BORDER_NORTH;
+}
+
+int Chunk::GetSkyHeight(int columnIndex) const
+{
+	return m_skyHeights[columnIndex];
+}
+
+void Chunk::SetSkyHeight(int columnIndex, int skyHeight)
+{
+	m_skyHeights[columnIndex] = (unsigned char) skyHeight;
+}
+
+bool Chunk::IsBlockSky(int blockIndex) const
+{
+	return (blockIndex >> CHUNK_BITS_XY) >= m_skyHeights[GetColumnIndexForBlockIndex(blockIndex)];
+}
+
+ChunkState Chunk::GetState() const
+{
+	return m_state;
+}
+
+void Chunk::SetState(ChunkState state)
+{
+	m_state = state;
+}
+
+bool Chunk::HasAllNeighbors() const
+{
+	return m_eastNeighbor != nullptr && m_westNeighbor != nullptr && m_northNeighbor != nullptr && m_southNeighbor != nullptr;
+}
+
+Chunk* Chunk::GetNeighbor(LightingBorder border) const
+{
+	if (border == LIGHTING_BORDER_EAST)
+		return m_eastNeighbor;
+	if (border == LIGHTING_BORDER_WEST)
+		return m_westNeighbor;
+	if (border == LIGHTING_BORDER_NORTH)
+		return m_northNeighbor;
+	return m_southNeighbor;
+}
+
+bool Chunk::UpdateLOD(float distanceToPlayer)
+{
+	//a chunk has to move past a boundary by the hysteresis distance before it switches
+	ChunkLOD lod = m_lod;
+	while (lod < NUM_CHUNK_LODS - 1 && distanceToPlayer > CHUNK_LOD_DISTANCES[lod + 1] + CHUNK_LOD_HYSTERESIS)
+	{
+		lod = (ChunkLOD) (lod + 1);
+	}
+	while (lod > CHUNK_LOD_FULL && distanceToPlayer < CHUNK_LOD_DISTANCES[lod] - CHUNK_LOD_HYSTERESIS)
+	{
+		lod = (ChunkLOD) (lod - 1);
+	}
+
+	if (lod == m_lod)
+		return false;
+	m_lod = lod;
+	return true;
+}
+
+ChunkLOD Chunk::GetLOD() const
+{
+	return m_lod;
+}
+
 void Chunk::SetIsDirty(bool isDirty)
 {
-	m_isDirty = isDirty;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		m_sections[sectionIndex].m_isDirty = isDirty;
+	}
+}
+
+void Chunk::SetBlockIsDirty(int blockIndex)
+{
+	//a block on a section boundary also shows up in the faces of the section next to it
+	int sectionIndex = GetSectionIndexForBlockIndex(blockIndex);
+	int blockIndexZInSection = (blockIndex >> CHUNK_BITS_XY) & (CHUNK_SECTION_BLOCKS_TALL_Z - 1);
+	m_sections[sectionIndex].m_isDirty = true;
+	if (blockIndexZInSection == 0 && sectionIndex > 0)
+		m_sections[sectionIndex - 1].m_isDirty = true;
+	if (blockIndexZInSection == CHUNK_SECTION_BLOCKS_TALL_Z - 1 && sectionIndex < NUM_SECTIONS_PER_CHUNK - 1)
+		m_sections[sectionIndex + 1].m_isDirty = true;
+}
+
+void Chunk::SetBlockLightIsDirty(int blockIndex)
+{
+	//the light of a block colors the faces around it, which can belong to the section next to it
+	int sectionIndex = GetSectionIndexForBlockIndex(blockIndex);
+	int blockIndexZInSection = (blockIndex >> CHUNK_BITS_XY) & (CHUNK_SECTION_BLOCKS_TALL_Z - 1);
+	SetSectionLightIsDirty(sectionIndex);
+	if (blockIndexZInSection == 0 && sectionIndex > 0)
+		SetSectionLightIsDirty(sectionIndex - 1);
+	if (blockIndexZInSection == CHUNK_SECTION_BLOCKS_TALL_Z - 1 && sectionIndex < NUM_SECTIONS_PER_CHUNK - 1)
+		SetSectionLightIsDirty(sectionIndex + 1);
+}
+
+void Chunk::SetSectionLightIsDirty(int sectionIndex)
+{
+	if (m_sections[sectionIndex].m_canRecolor)
+		m_sections[sectionIndex].m_isLightDirty = true;
+	else
+		m_sections[sectionIndex].m_isDirty = true;
 }
 
 void Chunk::GetRLEBlockData(std::vector< unsigned char >& blockData)
 {
-	unsigned char currentBlockType = 0;
-	unsigned char numBlocksForBlockType = 0;
-	for (int blockIndex = 0; blockIndex <= NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+	unsigned char currentBlockType = m_blocks[0].m_blockType;
+	int numBlocksForBlockType = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
 	{
-		if (m_blocks[blockIndex].m_blockType == currentBlockType)
+		//all air sections extend the current run without walking their blocks
+		if (m_sections[sectionIndex].m_isAllAir)
 		{
-			numBlocksForBlockType++;
+			if (currentBlockType != BLOCK_TYPE_AIR)
+			{
+				AppendRLERun(blockData, currentBlockType, numBlocksForBlockType);
+				currentBlockType = BLOCK_TYPE_AIR;
+				numBlocksForBlockType = 0;
+			}
+			numBlocksForBlockType += NUM_BLOCKS_PER_SECTION;
+			continue;
 		}
-		else if (m_blocks[blockIndex].m_blockType != currentBlockType)
+
+		int firstBlockIndex = sectionIndex * NUM_BLOCKS_PER_SECTION;
+		for (int blockIndex = firstBlockIndex; blockIndex < firstBlockIndex + NUM_BLOCKS_PER_SECTION; ++blockIndex)
 		{
-			if ( !blockData.empty() )
+			if (m_blocks[blockIndex].m_blockType == currentBlockType)
+			{
+				numBlocksForBlockType++;
+			}
+			else
 			{
-				blockData.push_back( (unsigned char)currentBlockType );
-				blockData.push_back(numBlocksForBlockType);
+				AppendRLERun(blockData, currentBlockType, numBlocksForBlockType);
+				currentBlockType = m_blocks[blockIndex].m_blockType;
+				numBlocksForBlockType = 1;
 			}
-			currentBlockType = m_blocks[blockIndex].m_blockType;
-			numBlocksForBlockType = 1;
 		}
+	}
+	AppendRLERun(blockData, currentBlockType, numBlocksForBlockType);
+}
+
+void Chunk::AppendRLELightData(std::vector< unsigned char >& chunkData, bool isLightSettled) const
+{
+	//the stamp ties the light to the block runs before it, light still being solved is left out and flooded on load
+	if (!isLightSettled)
+	{
+		chunkData.push_back(0);
+		return;
+	}
+
+	uint32_t blockDataStamp = CalcBlockDataStamp(chunkData, 0, (int) chunkData.size());
+	chunkData.push_back(CHUNK_LIGHT_DATA_VERSION);
+	for (int byteIndex = 0; byteIndex < (int) sizeof(blockDataStamp); ++byteIndex)
+	{
+		chunkData.push_back((unsigned char) (blockDataStamp >> (byteIndex * 8)));
+	}
+
+	//sky over block light packed in one byte, open sky and solid ground make long runs
+	std::vector< unsigned char > packedLights(NUM_BLOCKS_PER_CHUNK);
+	for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+	{
+		packedLights[blockIndex] = (unsigned char) m_blocks[blockIndex].GetPackedLight();
+	}
+	AppendRLEBytes(chunkData, &packedLights[0], NUM_BLOCKS_PER_CHUNK);
+
+	//the neighbor faces this light was solved against, so a neighbor that changed while this chunk was away can be reconciled
+	std::vector< unsigned char > borderLight;
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		const Chunk* neighbor = GetNeighbor((LightingBorder) borderIndex);
+		if (neighbor != nullptr)
+			neighbor->CopyBorderLight(GetOppositeBorder((LightingBorder) borderIndex), borderLight);
+		else
+			borderLight = m_pendingBorderLight[borderIndex];
+
+		chunkData.push_back(borderLight.empty() ? 0 : 1);
+		if (!borderLight.empty())
+			AppendRLEBytes(chunkData, &borderLight[0], LIGHTING_BORDER_SIZE);
+	}
+}
+
+bool Chunk::ReadRLELightData(const std::vector< unsigned char >& chunkData, int readIndex, int blockDataStartIndex)
+{
+	int stampSize = (int) sizeof(uint32_t);
+	if (readIndex + 1 + stampSize > (int) chunkData.size() || chunkData[readIndex] != CHUNK_LIGHT_DATA_VERSION)
+		return false;
+
+	uint32_t blockDataStamp = 0;
+	for (int byteIndex = 0; byteIndex < stampSize; ++byteIndex)
+	{
+		blockDataStamp |= (uint32_t) chunkData[readIndex + 1 + byteIndex] << (byteIndex * 8);
+	}
+	if (blockDataStamp != CalcBlockDataStamp(chunkData, blockDataStartIndex, readIndex))
+		return false;
+	readIndex += 1 + stampSize;
+
+	//nothing is kept until every run checks out, a damaged file is flooded instead
+	std::vector< unsigned char > packedLights(NUM_BLOCKS_PER_CHUNK);
+	if (!ReadRLEBytes(chunkData, readIndex, &packedLights[0], NUM_BLOCKS_PER_CHUNK))
+		return false;
+
+	std::vector< unsigned char > borderLights[NUM_LIGHTING_BORDERS];
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		if (readIndex >= (int) chunkData.size())
+			return false;
+		bool hasBorderLight = chunkData[readIndex] != 0;
+		++readIndex;
+		if (!hasBorderLight)
+			continue;
+
+		borderLights[borderIndex].resize(LIGHTING_BORDER_SIZE);
+		if (!ReadRLEBytes(chunkData, readIndex, &borderLights[borderIndex][0], LIGHTING_BORDER_SIZE))
+			return false;
+	}
+
+	for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+	{
+		m_blocks[blockIndex].SetSkyLightLevel(Block::GetSkyLightLevelForPackedLight(packedLights[blockIndex]));
+		m_blocks[blockIndex].SetLightLevel(Block::GetLightLevelForPackedLight(packedLights[blockIndex]));
+	}
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		m_pendingBorderLight[borderIndex].swap(borderLights[borderIndex]);
+	}
+	return true;
+}
+
+void Chunk::CopyBorderLight(LightingBorder border, std::vector< unsigned char >& borderLight) const
+{
+	borderLight.resize(LIGHTING_BORDER_SIZE);
+	for (int borderIndex = 0; borderIndex < LIGHTING_BORDER_SIZE; ++borderIndex)
+	{
+		borderLight[borderIndex] = (unsigned char) m_blocks[GetBlockIndexForBorderIndex(border, borderIndex)].GetPackedLight();
+	}
+}
+
+void Chunk::AppendRLERun(std::vector< unsigned char >& blockData, unsigned char blockType, int numBlocks)
+{
+	while (numBlocks > 0)
+	{
+		unsigned char runLength = 255;
+		if (numBlocks < 255)
+			runLength = (unsigned char) numBlocks;
+		blockData.push_back(blockType);
+		blockData.push_back(runLength);
+		numBlocks -= runLength;
+	}
+}
+
+void Chunk::AppendRLEBytes(std::vector< unsigned char >& chunkData, const unsigned char* values, int numValues)
+{
+	unsigned char currentValue = values[0];
+	int numValuesForRun = 0;
+	for (int valueIndex = 0; valueIndex < numValues; ++valueIndex)
+	{
+		if (values[valueIndex] == currentValue)
+		{
+			numValuesForRun++;
+		}
+		else
+		{
+			AppendRLERun(chunkData, currentValue, numValuesForRun);
+			currentValue = values[valueIndex];
+			numValuesForRun = 1;
+		}
+	}
+	AppendRLERun(chunkData, currentValue, numValuesForRun);
+}
+
+bool Chunk::ReadRLEBytes(const std::vector< unsigned char >& chunkData, int& readIndex, unsigned char* values, int numValues)
+{
+	//runs have to fill the values exactly
+	int valueIndex = 0;
+	while (valueIndex < numValues)
+	{
+		if (readIndex + 1 >= (int) chunkData.size() || valueIndex + chunkData[readIndex + 1] > numValues)
+			return false;
 
-		if (numBlocksForBlockType == 255)
+		for (int runIndex = 0; runIndex < chunkData[readIndex + 1]; ++runIndex)
 		{
-			blockData.push_back( (unsigned char) currentBlockType );
-			blockData.push_back(numBlocksForBlockType);
-			numBlocksForBlockType = 0;
+			values[valueIndex] = chunkData[readIndex];
+			++valueIndex;
 		}
+		readIndex += 2;
 	}
+	return true;
 }
 
+uint32_t Chunk::CalcBlockDataStamp(const std::vector< unsigned char >& chunkData, int firstIndex, int endIndex)
+{
+	//FNV-1a over the block type runs
+	uint32_t blockDataStamp = 2166136261U;
+	for (int byteIndex = firstIndex; byteIndex < endIndex; ++byteIndex)
+	{
+		blockDataStamp = (blockDataStamp ^ chunkData[byteIndex]) * 16777619U;
+	}
+	return blockDataStamp;
+}
@@ -2,13 +2,68 @@
 #include "Game/Block.hpp"
 #include "Game/BlockDefinition.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/ChunkVertex.hpp"
 #include "Engine/Math/IntVector2.hpp"
 #include "Engine/Math/AABB3D.hpp"
 #include <vector>
+#include <stdint.h>
 
 class SpriteSheet;
 class IntVector3;
-struct Vertex3_PCT;
+struct ChunkMeshInput;
+struct ChunkMeshResult;
+
+//distant chunks are meshed from 2x2x2 or 4x4x4 block cells
+enum ChunkLOD
+{
+	CHUNK_LOD_FULL,
+	CHUNK_LOD_2X,
+	CHUNK_LOD_4X,
+	NUM_CHUNK_LODS
+};
+
+//a chunk is meshed once its light has settled and all four neighbors are loaded
+enum ChunkState
+{
+	CHUNK_STATE_GENERATED,
+	CHUNK_STATE_LIT,
+	CHUNK_STATE_NEIGHBORS_READY,
+	CHUNK_STATE_MESHED,
+	NUM_CHUNK_STATES
+};
+
+//the four sides a chunk shares with its neighbors, a border runs along one of them for the full height
+enum LightingBorder
+{
+	LIGHTING_BORDER_EAST,
+	LIGHTING_BORDER_WEST,
+	LIGHTING_BORDER_NORTH,
+	LIGHTING_BORDER_SOUTH,
+	NUM_LIGHTING_BORDERS
+};
+
+const int LIGHTING_BORDER_SIZE = CHUNK_BLOCKS_WIDE_X * CHUNK_BLOCKS_TALL_Z;
+const unsigned char CHUNK_FILE_VERSION_WITHOUT_LIGHT = 1; //block types only, the light is flooded after loading
+const unsigned char CHUNK_LIGHT_DATA_VERSION = 1; //bump when the lighting rules change so light saved before is flooded again
+const int CHUNK_FILE_HEADER_SIZE = 4; //version and dimensions
+const float CHUNK_LOD_DISTANCES[NUM_CHUNK_LODS] = { 0.f, 48.f, 80.f }; //distance to the player where each LOD starts
+const float CHUNK_LOD_HYSTERESIS = 8.f; //keeps chunks on a boundary from remeshing every step
+
+//16 block tall slice of a chunk column with its own mesh
+struct ChunkSection
+{
+	unsigned int m_vboID; //holds the packed vertexes as they are
+	std::vector< ChunkVertex > m_vertexes; //copy of what the VBO holds, source for recoloring and the mesh cache
+	int m_numVertexes; //packed quad corners
+	int m_numIndexes; //drawn as triangles through the shared quad index buffer
+	int m_latestMeshJobID;
+	int m_appliedMeshJobID;
+	bool m_isDirty;
+	bool m_isLightDirty; //only the light of existing faces changed
+	bool m_canRecolor; //false for greedy and LOD meshes, their quads depend on light
+	bool m_isAllAir;
+	bool m_isAllOpaque;
+};
 
 class Chunk
 {
@@ -19,17 +74,32 @@ public:
 	Chunk* m_westNeighbor;
 	Chunk* m_northNeighbor;
 	Chunk* m_southNeighbor;
+	ChunkSection m_sections[NUM_SECTIONS_PER_CHUNK];
+	bool m_isQueuedForRemesh; //owned by the remesh scheduler
+	int m_numDirtyLightingBlocks; //entries still waiting in the world lighting queue
+	int m_slotIndex; //assigned by the world while the chunk is active
+	bool m_hasCachedMesh; //loaded from a save, its first mesh may come from the mesh cache
+	bool m_hasSavedLight; //loaded with light that matched its blocks, it does not need the flood fill
+	std::vector< unsigned char > m_pendingBorderLight[NUM_LIGHTING_BORDERS]; //packed light of the neighbor face the light was solved against while that neighbor is away, empty when nothing is pending
 
-	Chunk();
-	Chunk(IntVector2 chunkCoords, BlockDefinition* blockDefs[]);
-	Chunk(IntVector2 chunkCoords, BlockDefinition* blockDefs[], const std::vector< unsigned char > chunkData); 
+	Chunk(); //only creates the section VBOs, Reset fills the chunk every time it is taken from the pool
 	~Chunk();
 
+	void Reset(IntVector2 chunkCoords, BlockDefinition* blockDefs[]);
+	void Reset(IntVector2 chunkCoords, BlockDefinition* blockDefs[], const std::vector< unsigned char >& chunkData);
+
+	void InitSections();
 	void InitBlocks();
-	void InitIsSkyAndDirtyBlocks();
-	void GenerateVertexArray();
+	void UpdateSectionFlags(int sectionIndex);
+	void UpdateAllSectionFlags();
+	void InitSkyHeights();
+	void CreateMeshInput(ChunkMeshInput& meshInput, int meshJobID);
+	void CopyToMeshInput(ChunkMeshInput& meshInput) const;
+	int ApplyMeshResult(ChunkMeshResult& meshResult);
+	int RecolorLightDirtySections(int maxBytesToUpload);
 
 	void SetFrustumCulling(const Vector3& cameraForwardXYZ, const Vector3& cameraPos);
+	bool IsVisible() const;
 	Vector3 GetCornerWorldPosFromIndex(int cornerIndex);
 
 	void Render() const;
@@ -41,21 +111,57 @@ public:
 	IntVector2 GetChunkCoords();
 	Vector3 GetChunkCenterWorldCoords();
 	void GetRLEBlockData(std::vector< unsigned char >& blockData);
+	void AppendRLELightData(std::vector< unsigned char >& chunkData, bool isLightSettled) const;
+	void CopyBorderLight(LightingBorder border, std::vector< unsigned char >& borderLight) const;
+	static void AppendRLERun(std::vector< unsigned char >& blockData, unsigned char blockType, int numBlocks);
+	static void AppendRLEBytes(std::vector< unsigned char >& chunkData, const unsigned char* values, int numValues);
+	static bool ReadRLEBytes(const std::vector< unsigned char >& chunkData, int& readIndex, unsigned char* values, int numValues);
+	static uint32_t CalcBlockDataStamp(const std::vector< unsigned char >& chunkData, int firstIndex, int endIndex);
+
+	static int GetBlockIndexForBlockCoords(const IntVector3& blockCoords);
+	static IntVector3 GetBlockCoordsForBlockIndex(int blockIndex);
+	static int GetSectionIndexForBlockIndex(int blockIndex);
+	static int GetColumnIndexForBlockIndex(int blockIndex);
+	static int GetBlockIndexForBorderIndex(LightingBorder border, int borderIndex);
+	static LightingBorder GetOppositeBorder(LightingBorder border);
 
-	int GetBlockIndexForBlockCoords(const IntVector3& blockCoords) const;
-	IntVector3 GetBlockCoordsForBlockIndex(int blockIndex) const;
+	int GetSkyHeight(int columnIndex) const;
+	void SetSkyHeight(int columnIndex, int skyHeight);
+	bool IsBlockSky(int blockIndex) const;
+
+	ChunkState GetState() const;
+	void SetState(ChunkState state);
+	bool HasAllNeighbors() const;
+	Chunk* GetNeighbor(LightingBorder border) const;
+
+	bool UpdateLOD(float distanceToPlayer);
+	ChunkLOD GetLOD() const;
 
 	void SetIsDirty(bool isDirty);
 	bool IsChunkDirty();
+	bool IsLightDirty() const;
+	void SetBlockIsDirty(int blockIndex);
+	void SetBlockLightIsDirty(int blockIndex);
+	int GetNumVertexes() const;
+	int GetNumIndexes() const;
+	int CalcNumPackedVertexBytes() const;
+	int CalcNumVBOBytes() const;
 
 private:
-	bool m_isDirty;
+	void ResetState(IntVector2 chunkCoords);
+	bool ReadRLELightData(const std::vector< unsigned char >& chunkData, int readIndex, int blockDataStartIndex);
+	void SetSectionLightIsDirty(int sectionIndex);
+	void RecolorSection(int sectionIndex);
+	int CalcQuadPackedLight(const ChunkVertex* quadVertexes) const;
+	int GetPackedLightAtLocalCoords(const IntVector3& blockCoords) const;
+
 	bool m_isVisible;
+	ChunkLOD m_lod;
+	ChunkState m_state;
+	unsigned char m_skyHeights[CHUNK_BLOCKS_PER_LAYER]; //one above the highest opaque block of each column, everything from there up is sky
 
 	IntVector2 m_chunkCoords;
 	AABB3D m_worldBounds; //the position in the world //make this an AABB3D
 	BlockDefinition* m_blockDefinitions[BLOCK_TYPE_SIZE];
 	SpriteSheet* m_spriteSheet;
-	unsigned int m_vboID;
-	int m_numVertexes;
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "Game/ChunkActivationFrontier.hpp"
+#include <algorithm>
+
+static bool IsFartherCandidate(const ChunkActivationCandidate& first, const ChunkActivationCandidate& second)
+{
+	return first.m_distanceSquared > second.m_distanceSquared;
+}
+
+static bool IsCandidateCoordsBefore(const ChunkActivationCandidate& first, const ChunkActivationCandidate& second)
+{
+	return first.m_chunkCoords.y < second.m_chunkCoords.y || (first.m_chunkCoords.y == second.m_chunkCoords.y && first.m_chunkCoords.x < second.m_chunkCoords.x);
+}
+
+static bool IsCandidateCoordsEqual(const ChunkActivationCandidate& first, const ChunkActivationCandidate& second)
+{
+	return first.m_chunkCoords.x == second.m_chunkCoords.x && first.m_chunkCoords.y == second.m_chunkCoords.y;
+}
+
+ChunkActivationFrontier::ChunkActivationFrontier()
+	: m_centerChunkCoords(0, 0)
+{
+}
+
+void ChunkActivationFrontier::AddMissingNeighbors(const ActiveChunkMap& activeChunks, const IntVector2& chunkCoords)
+{
+	IntVector2 neighborCoords[4] = { IntVector2(chunkCoords.x + 1, chunkCoords.y), IntVector2(chunkCoords.x - 1, chunkCoords.y),
+									 IntVector2(chunkCoords.x, chunkCoords.y + 1), IntVector2(chunkCoords.x, chunkCoords.y - 1) };
+	for (int neighborIndex = 0; neighborIndex < 4; ++neighborIndex)
+	{
+		if (activeChunks.Find(neighborCoords[neighborIndex]) == nullptr)
+			AddCandidate(neighborCoords[neighborIndex]);
+	}
+}
+
+void ChunkActivationFrontier::AddDeactivatedChunk(const ActiveChunkMap& activeChunks, const IntVector2& chunkCoords)
+{
+	//neighbors left without an active chunk next to them are dropped when they reach the top
+	if (IsCandidateMissing(activeChunks, chunkCoords))
+		AddCandidate(chunkCoords);
+}
+
+void ChunkActivationFrontier::SetCenter(const ActiveChunkMap& activeChunks, const IntVector2& centerChunkCoords)
+{
+	if (centerChunkCoords.x == m_centerChunkCoords.x && centerChunkCoords.y == m_centerChunkCoords.y)
+		return;
+
+	//the player entered another chunk, so stale and repeated entries are dropped while every distance is rekeyed
+	m_centerChunkCoords = centerChunkCoords;
+	std::sort(m_candidates.begin(), m_candidates.end(), IsCandidateCoordsBefore);
+	m_candidates.erase(std::unique(m_candidates.begin(), m_candidates.end(), IsCandidateCoordsEqual), m_candidates.end());
+
+	int numCandidates = 0;
+	for (int candidateIndex = 0; candidateIndex < (int) m_candidates.size(); ++candidateIndex)
+	{
+		if (!IsCandidateMissing(activeChunks, m_candidates[candidateIndex].m_chunkCoords))
+			continue;
+
+		m_candidates[numCandidates] = m_candidates[candidateIndex];
+		m_candidates[numCandidates].m_distanceSquared = CalcDistanceSquared(m_candidates[numCandidates].m_chunkCoords);
+		++numCandidates;
+	}
+	m_candidates.resize(numCandidates);
+	std::make_heap(m_candidates.begin(), m_candidates.end(), IsFartherCandidate);
+}
+
+bool ChunkActivationFrontier::GetClosest(const ActiveChunkMap& activeChunks, IntVector2& out_chunkCoords)
+{
+	while (!m_candidates.empty())
+	{
+		if (IsCandidateMissing(activeChunks, m_candidates.front().m_chunkCoords))
+		{
+			out_chunkCoords = m_candidates.front().m_chunkCoords;
+			return true;
+		}
+		PopClosest();
+	}
+	return false;
+}
+
+void ChunkActivationFrontier::PopClosest()
+{
+	if (m_candidates.empty())
+		return;
+
+	std::pop_heap(m_candidates.begin(), m_candidates.end(), IsFartherCandidate);
+	m_candidates.pop_back();
+}
+
+int ChunkActivationFrontier::GetNumCandidates() const
+{
+	return (int) m_candidates.size();
+}
+
+void ChunkActivationFrontier::AddCandidate(const IntVector2& chunkCoords)
+{
+	ChunkActivationCandidate candidate;
+	candidate.m_chunkCoords = chunkCoords;
+	candidate.m_distanceSquared = CalcDistanceSquared(chunkCoords);
+	m_candidates.push_back(candidate);
+	std::push_heap(m_candidates.begin(), m_candidates.end(), IsFartherCandidate);
+}
+
+int ChunkActivationFrontier::CalcDistanceSquared(const IntVector2& chunkCoords) const
+{
+	int deltaX = chunkCoords.x - m_centerChunkCoords.x;
+	int deltaY = chunkCoords.y - m_centerChunkCoords.y;
+	return (deltaX * deltaX) + (deltaY * deltaY);
+}
+
+bool ChunkActivationFrontier::IsCandidateMissing(const ActiveChunkMap& activeChunks, const IntVector2& chunkCoords)
+{
+	//still missing and still touching an active chunk
+	if (activeChunks.Find(chunkCoords) != nullptr)
+		return false;
+	return activeChunks.Find(IntVector2(chunkCoords.x + 1, chunkCoords.y)) != nullptr || activeChunks.Find(IntVector2(chunkCoords.x - 1, chunkCoords.y)) != nullptr
+		|| activeChunks.Find(IntVector2(chunkCoords.x, chunkCoords.y + 1)) != nullptr || activeChunks.Find(IntVector2(chunkCoords.x, chunkCoords.y - 1)) != nullptr;
+}
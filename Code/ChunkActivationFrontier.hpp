@@ -0,0 +1,34 @@
+#pragma once
+#include "Game/ActiveChunkMap.hpp"
+#include "Engine/Math/IntVector2.hpp"
+#include <vector>
+
+struct ChunkActivationCandidate
+{
+	IntVector2 m_chunkCoords;
+	int m_distanceSquared; //in chunks from the center the frontier was last keyed on
+};
+
+//missing chunks next to active ones, closest to the player first
+//entries are checked when they reach the top, so activations and deactivations only ever push
+class ChunkActivationFrontier
+{
+public:
+	ChunkActivationFrontier();
+
+	void AddMissingNeighbors(const ActiveChunkMap& activeChunks, const IntVector2& chunkCoords);
+	void AddDeactivatedChunk(const ActiveChunkMap& activeChunks, const IntVector2& chunkCoords);
+	void SetCenter(const ActiveChunkMap& activeChunks, const IntVector2& centerChunkCoords);
+	bool GetClosest(const ActiveChunkMap& activeChunks, IntVector2& out_chunkCoords);
+	void PopClosest();
+	int GetNumCandidates() const;
+
+private:
+	void AddCandidate(const IntVector2& chunkCoords);
+	int CalcDistanceSquared(const IntVector2& chunkCoords) const;
+
+	static bool IsCandidateMissing(const ActiveChunkMap& activeChunks, const IntVector2& chunkCoords);
+
+	std::vector< ChunkActivationCandidate > m_candidates; //min heap on distance, may hold stale and repeated coords
+	IntVector2 m_centerChunkCoords;
+};
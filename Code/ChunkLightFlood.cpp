@@ -0,0 +1,149 @@
+#include "Game/ChunkLightFlood.hpp"
+
+#ifdef CHUNK_LIGHT_FLOOD_SSE2
+#include <emmintrin.h>
+#endif
+
+static bool RelaxRow(unsigned char* levels, const unsigned char* isTransparentMasks, int rowStart, int blockIndexY, int blockIndexZ)
+{
+	//each block takes the brightest of its six neighbors minus one, opaque blocks keep what they were seeded with
+#ifdef CHUNK_LIGHT_FLOOD_SSE2
+	//a row is 16 blocks wide, so shifting the register by one byte lines up the east and west neighbors
+	__m128i row = _mm_loadu_si128((const __m128i*) (levels + rowStart));
+	__m128i brightest = _mm_max_epu8(_mm_slli_si128(row, 1), _mm_srli_si128(row, 1));
+	if (blockIndexY > 0)
+		brightest = _mm_max_epu8(brightest, _mm_loadu_si128((const __m128i*) (levels + rowStart - CHUNK_BLOCKS_WIDE_X)));
+	if (blockIndexY < CHUNK_BLOCKS_DEEP_Y - 1)
+		brightest = _mm_max_epu8(brightest, _mm_loadu_si128((const __m128i*) (levels + rowStart + CHUNK_BLOCKS_WIDE_X)));
+	if (blockIndexZ > 0)
+		brightest = _mm_max_epu8(brightest, _mm_loadu_si128((const __m128i*) (levels + rowStart - CHUNK_BLOCKS_PER_LAYER)));
+	if (blockIndexZ < CHUNK_BLOCKS_TALL_Z - 1)
+		brightest = _mm_max_epu8(brightest, _mm_loadu_si128((const __m128i*) (levels + rowStart + CHUNK_BLOCKS_PER_LAYER)));
+
+	brightest = _mm_and_si128(_mm_subs_epu8(brightest, _mm_set1_epi8(1)), _mm_loadu_si128((const __m128i*) (isTransparentMasks + rowStart)));
+	__m128i relaxedRow = _mm_max_epu8(row, brightest);
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(relaxedRow, row)) == 0xFFFF)
+		return false;
+
+	_mm_storeu_si128((__m128i*) (levels + rowStart), relaxedRow);
+	return true;
+#else
+	bool hasRowChanged = false;
+	for (int blockIndexX = 0; blockIndexX < CHUNK_BLOCKS_WIDE_X; ++blockIndexX)
+	{
+		int blockIndex = rowStart + blockIndexX;
+		if (isTransparentMasks[blockIndex] == 0)
+			continue;
+
+		int brightest = 0;
+		if (blockIndexX > 0 && levels[blockIndex - 1] > brightest)
+			brightest = levels[blockIndex - 1];
+		if (blockIndexX < CHUNK_BLOCKS_WIDE_X - 1 && levels[blockIndex + 1] > brightest)
+			brightest = levels[blockIndex + 1];
+		if (blockIndexY > 0 && levels[blockIndex - CHUNK_BLOCKS_WIDE_X] > brightest)
+			brightest = levels[blockIndex - CHUNK_BLOCKS_WIDE_X];
+		if (blockIndexY < CHUNK_BLOCKS_DEEP_Y - 1 && levels[blockIndex + CHUNK_BLOCKS_WIDE_X] > brightest)
+			brightest = levels[blockIndex + CHUNK_BLOCKS_WIDE_X];
+		if (blockIndexZ > 0 && levels[blockIndex - CHUNK_BLOCKS_PER_LAYER] > brightest)
+			brightest = levels[blockIndex - CHUNK_BLOCKS_PER_LAYER];
+		if (blockIndexZ < CHUNK_BLOCKS_TALL_Z - 1 && levels[blockIndex + CHUNK_BLOCKS_PER_LAYER] > brightest)
+			brightest = levels[blockIndex + CHUNK_BLOCKS_PER_LAYER];
+
+		if (brightest - 1 > levels[blockIndex])
+		{
+			levels[blockIndex] = (unsigned char) (brightest - 1);
+			hasRowChanged = true;
+		}
+	}
+	return hasRowChanged;
+#endif
+}
+
+ChunkLightFlood::ChunkLightFlood()
+	: m_skyLightLevels(NUM_BLOCKS_PER_CHUNK)
+	, m_lightLevels(NUM_BLOCKS_PER_CHUNK)
+	, m_isTransparentMasks(NUM_BLOCKS_PER_CHUNK)
+{
+	for (int blockIndexZ = 0; blockIndexZ < CHUNK_BLOCKS_TALL_Z; ++blockIndexZ)
+	{
+		m_isLayerActive[blockIndexZ] = false;
+	}
+}
+
+void ChunkLightFlood::FloodChunk(Chunk& chunk, BlockDefinition* blockDefinitions[])
+{
+	InitLayers(chunk, blockDefinitions);
+	for (int blockIndexZ = 0; blockIndexZ < CHUNK_BLOCKS_TALL_Z; ++blockIndexZ)
+	{
+		m_isLayerActive[blockIndexZ] = true;
+	}
+
+	//sweeping up and then down carries light the full height of the chunk each pass
+	bool hasLightChanged = true;
+	while (hasLightChanged)
+	{
+		hasLightChanged = false;
+		for (int sweepIndex = 0; sweepIndex < 2 * CHUNK_BLOCKS_TALL_Z; ++sweepIndex)
+		{
+			int blockIndexZ = sweepIndex < CHUNK_BLOCKS_TALL_Z ? sweepIndex : 2 * CHUNK_BLOCKS_TALL_Z - 1 - sweepIndex;
+			if (!m_isLayerActive[blockIndexZ])
+				continue;
+
+			m_isLayerActive[blockIndexZ] = false;
+			if (!RelaxLayer(blockIndexZ))
+				continue;
+
+			hasLightChanged = true;
+			if (blockIndexZ > 0)
+				m_isLayerActive[blockIndexZ - 1] = true;
+			if (blockIndexZ < CHUNK_BLOCKS_TALL_Z - 1)
+				m_isLayerActive[blockIndexZ + 1] = true;
+		}
+	}
+
+	StoreLayers(chunk);
+}
+
+void ChunkLightFlood::InitLayers(const Chunk& chunk, BlockDefinition* blockDefinitions[])
+{
+	//seeded the same way the queue seeds a block before pulling from its neighbors
+	for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+	{
+		const Block& block = chunk.m_blocks[blockIndex];
+		bool isOpaque = block.GetIsOpaque();
+		m_isTransparentMasks[blockIndex] = isOpaque ? 0 : 0xFF;
+		m_skyLightLevels[blockIndex] = (!isOpaque && chunk.IsBlockSky(blockIndex)) ? MASK_LIGHT : 0;
+		m_lightLevels[blockIndex] = (unsigned char) blockDefinitions[block.m_blockType]->GetSelfIllumination();
+	}
+}
+
+bool ChunkLightFlood::RelaxLayer(int blockIndexZ)
+{
+	//light can wind back and forth inside a layer, so it is relaxed until it settles
+	bool hasLayerChanged = false;
+	bool hasPassChanged = true;
+	while (hasPassChanged)
+	{
+		hasPassChanged = false;
+		for (int blockIndexY = 0; blockIndexY < CHUNK_BLOCKS_DEEP_Y; ++blockIndexY)
+		{
+			int rowStart = (blockIndexZ * CHUNK_BLOCKS_PER_LAYER) + (blockIndexY * CHUNK_BLOCKS_WIDE_X);
+			if (RelaxRow(&m_skyLightLevels[0], &m_isTransparentMasks[0], rowStart, blockIndexY, blockIndexZ))
+				hasPassChanged = true;
+			if (RelaxRow(&m_lightLevels[0], &m_isTransparentMasks[0], rowStart, blockIndexY, blockIndexZ))
+				hasPassChanged = true;
+		}
+		if (hasPassChanged)
+			hasLayerChanged = true;
+	}
+	return hasLayerChanged;
+}
+
+void ChunkLightFlood::StoreLayers(Chunk& chunk) const
+{
+	for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+	{
+		chunk.m_blocks[blockIndex].SetSkyLightLevel(m_skyLightLevels[blockIndex]);
+		chunk.m_blocks[blockIndex].SetLightLevel(m_lightLevels[blockIndex]);
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "Game/Chunk.hpp"
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHUNK_LIGHT_FLOOD_SSE2
+#endif
+
+//lights a whole chunk from scratch by relaxing one 16x16 z-layer at a time until nothing changes
+//gives the same light as the queue would for a chunk on its own, edits still go through the queue
+class ChunkLightFlood
+{
+public:
+	ChunkLightFlood();
+
+	void FloodChunk(Chunk& chunk, BlockDefinition* blockDefinitions[]);
+
+private:
+	void InitLayers(const Chunk& chunk, BlockDefinition* blockDefinitions[]);
+	bool RelaxLayer(int blockIndexZ);
+	void StoreLayers(Chunk& chunk) const;
+
+	//one byte per block in block index order, so a layer is 16 rows of 16 bytes
+	std::vector< unsigned char > m_skyLightLevels;
+	std::vector< unsigned char > m_lightLevels;
+	std::vector< unsigned char > m_isTransparentMasks; //0xFF where light passes, 0 for opaque blocks
+	bool m_isLayerActive[CHUNK_BLOCKS_TALL_Z]; //a layer is relaxed again only after it or a layer next to it changed
+};
@@ -0,0 +1,79 @@
+#include "Game/ChunkMeshArena.hpp"
+
+ChunkMeshArena::ChunkMeshArena()
+	: m_numAllocations(0)
+	, m_numAllocationsForLastRemesh(0)
+{
+}
+
+ChunkMeshArena::~ChunkMeshArena()
+{
+	for (int inputIndex = 0; inputIndex < (int) m_freeMeshInputs.size(); ++inputIndex)
+	{
+		delete m_freeMeshInputs[inputIndex];
+	}
+	m_freeMeshInputs.clear();
+
+	for (int resultIndex = 0; resultIndex < (int) m_freeMeshResults.size(); ++resultIndex)
+	{
+		delete m_freeMeshResults[resultIndex];
+	}
+	m_freeMeshResults.clear();
+}
+
+ChunkMeshInput* ChunkMeshArena::AcquireMeshInput(int& numAllocations)
+{
+	{
+		std::lock_guard< std::mutex > lock(m_freeMeshInputsMutex);
+		if (!m_freeMeshInputs.empty())
+		{
+			ChunkMeshInput* meshInput = m_freeMeshInputs.back();
+			m_freeMeshInputs.pop_back();
+			return meshInput;
+		}
+	}
+
+	++numAllocations;
+	return new ChunkMeshInput();
+}
+
+void ChunkMeshArena::ReleaseMeshInput(ChunkMeshInput* meshInput)
+{
+	std::lock_guard< std::mutex > lock(m_freeMeshInputsMutex);
+	m_freeMeshInputs.push_back(meshInput);
+}
+
+ChunkMeshResult* ChunkMeshArena::AcquireMeshResult(int& numAllocations)
+{
+	if (!m_freeMeshResults.empty())
+	{
+		ChunkMeshResult* meshResult = m_freeMeshResults.back();
+		m_freeMeshResults.pop_back();
+		return meshResult;
+	}
+
+	++numAllocations;
+	return new ChunkMeshResult();
+}
+
+void ChunkMeshArena::ReleaseMeshResult(ChunkMeshResult* meshResult)
+{
+	//the section vectors keep their capacity for the next job
+	m_freeMeshResults.push_back(meshResult);
+}
+
+void ChunkMeshArena::AddRemeshAllocations(int numAllocations)
+{
+	m_numAllocations += numAllocations;
+	m_numAllocationsForLastRemesh = numAllocations;
+}
+
+int ChunkMeshArena::GetNumAllocations() const
+{
+	return m_numAllocations;
+}
+
+int ChunkMeshArena::GetNumAllocationsForLastRemesh() const
+{
+	return m_numAllocationsForLastRemesh;
+}
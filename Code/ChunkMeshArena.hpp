@@ -0,0 +1,29 @@
+#pragma once
+#include "Game/ChunkMeshBuilder.hpp"
+#include <vector>
+#include <mutex>
+
+//recycles mesh inputs and results between jobs so a warm remesh never grows them
+//only counts its own buffers, the job queues count their growths and the driver copy made by each VBO upload is not seen at all
+class ChunkMeshArena
+{
+public:
+	ChunkMeshArena();
+	~ChunkMeshArena();
+
+	ChunkMeshInput* AcquireMeshInput(int& numAllocations);
+	void ReleaseMeshInput(ChunkMeshInput* meshInput); //safe to call from workers
+	ChunkMeshResult* AcquireMeshResult(int& numAllocations);
+	void ReleaseMeshResult(ChunkMeshResult* meshResult);
+
+	void AddRemeshAllocations(int numAllocations);
+	int GetNumAllocations() const;
+	int GetNumAllocationsForLastRemesh() const;
+
+private:
+	std::vector< ChunkMeshInput* > m_freeMeshInputs;
+	std::vector< ChunkMeshResult* > m_freeMeshResults;
+	std::mutex m_freeMeshInputsMutex;
+	int m_numAllocations;
+	int m_numAllocationsForLastRemesh;
+};
@@ -0,0 +1,547 @@
+#include "Game/ChunkMeshBuilder.hpp"
+#include "Game/Chunk.hpp"
+#include "Game/ChunkVertex.hpp"
+#include "Engine/Math/IntVector3.hpp"
+
+
+//padded index offset to the neighbor across each face, indexed by BlockFace
+const int PADDED_NEIGHBOR_OFFSETS[BLOCK_FACE_SIZE] = { -PADDED_BLOCKS_PER_LAYER, PADDED_BLOCKS_PER_LAYER, PADDED_BLOCKS_WIDE_X, -PADDED_BLOCKS_WIDE_X, 1, -1 };
+
+int ChunkMeshResult::CalcNumVertexes() const
+{
+	int numVertexes = 0;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		numVertexes += (int) m_sectionVertexes[sectionIndex].size();
+	}
+	return numVertexes;
+}
+
+int ChunkMeshResult::CalcNumIndexes() const
+{
+	return ChunkVertex::CalcNumIndexesForVertexes(CalcNumVertexes());
+}
+
+ChunkMeshBuilder::ChunkMeshBuilder(const ChunkMeshInput& meshInput)
+	: m_meshInput(meshInput)
+{
+	if (m_meshInput.m_isMaskCulling)
+		InitVisibleFaceMasks();
+}
+
+ChunkMeshBuilder::~ChunkMeshBuilder()
+{
+}
+
+void ChunkMeshBuilder::BuildMesh(ChunkMeshResult& meshResult) const
+{
+	meshResult.m_chunkCoords = m_meshInput.m_chunkCoords;
+	meshResult.m_meshJobID = m_meshInput.m_meshJobID;
+	meshResult.m_sectionMask = m_meshInput.m_dirtySectionMask;
+	meshResult.m_isRecolorable = !m_meshInput.m_isGreedyMeshing && m_meshInput.m_lod == CHUNK_LOD_FULL;
+
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		std::vector< ChunkVertex >& sectionVertexes = meshResult.m_sectionVertexes[sectionIndex];
+		sectionVertexes.clear();
+		if ((m_meshInput.m_dirtySectionMask & (1 << sectionIndex)) == 0)
+			continue;
+
+		if (m_meshInput.m_isSectionAllAir[sectionIndex] || IsSectionHidden(sectionIndex))
+			continue;
+
+		//leave room for a few edits past the last mesh so small changes do not regrow the storage
+		int startCapacity = (int) sectionVertexes.capacity();
+		int numReservedVertexes = m_meshInput.m_previousNumVertexes[sectionIndex];
+		sectionVertexes.reserve(numReservedVertexes + (numReservedVertexes >> 2));
+		BuildSectionMesh(sectionVertexes, sectionIndex);
+		if ((int) sectionVertexes.capacity() != startCapacity)
+			++meshResult.m_numAllocations;
+	}
+}
+
+bool ChunkMeshBuilder::IsSectionHidden(int sectionIndex) const
+{
+	//a solid section boxed in by solid sections has no visible faces, the world bottom is always drawn
+	if (!m_meshInput.m_isSectionAllOpaque[sectionIndex] || sectionIndex == 0)
+		return false;
+	if (sectionIndex < NUM_SECTIONS_PER_CHUNK - 1 && !m_meshInput.m_isSectionAllOpaque[sectionIndex + 1])
+		return false;
+	if (sectionIndex == NUM_SECTIONS_PER_CHUNK - 1 || !m_meshInput.m_isSectionAllOpaque[sectionIndex - 1])
+		return false;
+
+	return m_meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_NORTH][sectionIndex]
+		&& m_meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_SOUTH][sectionIndex]
+		&& m_meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_EAST][sectionIndex]
+		&& m_meshInput.m_isNeighborSectionAllOpaque[BLOCK_FACE_WEST][sectionIndex];
+}
+
+void ChunkMeshBuilder::BuildSectionMesh(std::vector< ChunkVertex >& chunkVertexes, int sectionIndex) const
+{
+	if (m_meshInput.m_lod != CHUNK_LOD_FULL)
+	{
+		AppendLODQuads(chunkVertexes, sectionIndex);
+	}
+	else if (m_meshInput.m_isGreedyMeshing)
+	{
+		for (int faceIndex = 0; faceIndex < BLOCK_FACE_SIZE; ++faceIndex)
+		{
+			AppendGreedyQuads(chunkVertexes, (BlockFace) faceIndex, sectionIndex);
+		}
+	}
+	else
+	{
+		AppendPerFaceQuads(chunkVertexes, sectionIndex);
+	}
+}
+
+void ChunkMeshBuilder::InitVisibleFaceMasks()
+{
+	//the padding z levels are never opaque, so shifting zeros in from either end is correct
+	ColumnMask opaqueMasks[PADDED_BLOCKS_PER_LAYER];
+	ColumnMask drawnMasks[CHUNK_BLOCKS_PER_LAYER];
+	for (int paddedColumnIndex = 0; paddedColumnIndex < PADDED_BLOCKS_PER_LAYER; ++paddedColumnIndex)
+	{
+		uint64_t lowBits = 0;
+		uint64_t highBits = 0;
+		const Block* column = &m_meshInput.m_paddedBlocks[paddedColumnIndex + PADDED_BLOCKS_PER_LAYER];
+		for (int blockIndexZ = 0; blockIndexZ < 64; ++blockIndexZ)
+		{
+			lowBits |= (uint64_t) ((column[blockIndexZ * PADDED_BLOCKS_PER_LAYER].m_lightingAndFlags & MASK_IS_OPAQUE) != 0) << blockIndexZ;
+			highBits |= (uint64_t) ((column[(blockIndexZ + 64) * PADDED_BLOCKS_PER_LAYER].m_lightingAndFlags & MASK_IS_OPAQUE) != 0) << blockIndexZ;
+		}
+		opaqueMasks[paddedColumnIndex].m_lowBits = lowBits;
+		opaqueMasks[paddedColumnIndex].m_highBits = highBits;
+	}
+
+	for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; ++columnIndex)
+	{
+		uint64_t lowBits = 0;
+		uint64_t highBits = 0;
+		const Block* column = &m_meshInput.m_paddedBlocks[GetPaddedIndexForBlockCoords(Chunk::GetBlockCoordsForBlockIndex(columnIndex))];
+		for (int blockIndexZ = 0; blockIndexZ < 64; ++blockIndexZ)
+		{
+			lowBits |= (uint64_t) (column[blockIndexZ * PADDED_BLOCKS_PER_LAYER].m_blockType != BLOCK_TYPE_AIR) << blockIndexZ;
+			highBits |= (uint64_t) (column[(blockIndexZ + 64) * PADDED_BLOCKS_PER_LAYER].m_blockType != BLOCK_TYPE_AIR) << blockIndexZ;
+		}
+		drawnMasks[columnIndex].m_lowBits = lowBits;
+		drawnMasks[columnIndex].m_highBits = highBits;
+	}
+
+	for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; ++columnIndex)
+	{
+		const ColumnMask& drawn = drawnMasks[columnIndex];
+		int paddedColumnIndex = GetPaddedIndexForBlockCoords(Chunk::GetBlockCoordsForBlockIndex(columnIndex)) - PADDED_BLOCKS_PER_LAYER;
+		const ColumnMask& opaque = opaqueMasks[paddedColumnIndex];
+
+		//a face is visible where the block is drawn and the block across the face is not opaque
+		ColumnMask& up = m_visibleFaceMasks[BLOCK_FACE_UP][columnIndex];
+		up.m_lowBits = drawn.m_lowBits & ~((opaque.m_lowBits >> 1) | (opaque.m_highBits << 63));
+		up.m_highBits = drawn.m_highBits & ~(opaque.m_highBits >> 1);
+
+		ColumnMask& down = m_visibleFaceMasks[BLOCK_FACE_DOWN][columnIndex];
+		down.m_lowBits = drawn.m_lowBits & ~(opaque.m_lowBits << 1);
+		down.m_highBits = drawn.m_highBits & ~((opaque.m_highBits << 1) | (opaque.m_lowBits >> 63));
+
+		for (int faceIndex = BLOCK_FACE_NORTH; faceIndex <= BLOCK_FACE_WEST; ++faceIndex)
+		{
+			const ColumnMask& neighborOpaque = opaqueMasks[paddedColumnIndex + PADDED_NEIGHBOR_OFFSETS[faceIndex]];
+			ColumnMask& lateral = m_visibleFaceMasks[faceIndex][columnIndex];
+			lateral.m_lowBits = drawn.m_lowBits & ~neighborOpaque.m_lowBits;
+			lateral.m_highBits = drawn.m_highBits & ~neighborOpaque.m_highBits;
+		}
+	}
+}
+
+int ChunkMeshBuilder::GetVisibleFaceBitsForSection(BlockFace face, int columnIndex, int sectionIndex) const
+{
+	//sections never straddle the two words of a column mask
+	const ColumnMask& mask = m_visibleFaceMasks[face][columnIndex];
+	int firstBlockIndexZ = sectionIndex * CHUNK_SECTION_BLOCKS_TALL_Z;
+	uint64_t bits = mask.m_lowBits;
+	if (firstBlockIndexZ >= 64)
+	{
+		bits = mask.m_highBits;
+		firstBlockIndexZ -= 64;
+	}
+	return (int) ((bits >> firstBlockIndexZ) & ((1 << CHUNK_SECTION_BLOCKS_TALL_Z) - 1));
+}
+
+void ChunkMeshBuilder::AppendPerFaceQuads(std::vector< ChunkVertex >& chunkVertexes, int sectionIndex) const
+{
+	if (m_meshInput.m_isMaskCulling)
+	{
+		//walk only the set bits of each column instead of testing every block
+		int firstBlockIndexZ = sectionIndex * CHUNK_SECTION_BLOCKS_TALL_Z;
+		for (int faceIndex = 0; faceIndex < BLOCK_FACE_SIZE; ++faceIndex)
+		{
+			BlockFace face = (BlockFace) faceIndex;
+			for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; ++columnIndex)
+			{
+				int visibleBits = GetVisibleFaceBitsForSection(face, columnIndex, sectionIndex);
+				for (int blockIndexZ = firstBlockIndexZ; visibleBits != 0; ++blockIndexZ, visibleBits >>= 1)
+				{
+					if ((visibleBits & 1) == 0)
+						continue;
+
+					IntVector3 blockCoords = Chunk::GetBlockCoordsForBlockIndex(columnIndex + (blockIndexZ * CHUNK_BLOCKS_PER_LAYER));
+					IntVector3 blockMaxs(blockCoords.x + 1, blockCoords.y + 1, blockCoords.z + 1);
+					int paddedIndex = GetPaddedIndexForBlockCoords(blockCoords);
+					const Block& neighbor = m_meshInput.m_paddedBlocks[paddedIndex + PADDED_NEIGHBOR_OFFSETS[face]];
+					AppendFaceQuad(chunkVertexes, face, blockCoords, blockMaxs, GetTileIndexForFace(m_meshInput.m_paddedBlocks[paddedIndex].m_blockType, face), neighbor.GetPackedLight());
+				}
+			}
+		}
+		return;
+	}
+
+	int firstBlockIndex = sectionIndex * NUM_BLOCKS_PER_SECTION;
+	for (int blockIndex = firstBlockIndex; blockIndex < firstBlockIndex + NUM_BLOCKS_PER_SECTION; ++blockIndex)
+	{
+		IntVector3 blockCoords = Chunk::GetBlockCoordsForBlockIndex(blockIndex);
+		int paddedIndex = GetPaddedIndexForBlockCoords(blockCoords);
+		unsigned char blockType = m_meshInput.m_paddedBlocks[paddedIndex].m_blockType;
+		if (blockType == BLOCK_TYPE_AIR)
+			continue;
+
+		IntVector3 blockMaxs(blockCoords.x + 1, blockCoords.y + 1, blockCoords.z + 1);
+
+		for (int faceIndex = 0; faceIndex < BLOCK_FACE_SIZE; ++faceIndex)
+		{
+			BlockFace face = (BlockFace) faceIndex;
+			int packedLight = CalcFacePackedLight(paddedIndex, face);
+			if (packedLight == FACE_HIDDEN)
+				continue;
+
+			AppendFaceQuad(chunkVertexes, face, blockCoords, blockMaxs, GetTileIndexForFace(blockType, face), packedLight);
+		}
+	}
+}
+
+void ChunkMeshBuilder::AppendGreedyQuads(std::vector< ChunkVertex >& chunkVertexes, BlockFace face, int sectionIndex) const
+{
+	//each slice is a plane perpendicular to the face normal, u and v run along the plane
+	int minZ = sectionIndex * CHUNK_SECTION_BLOCKS_TALL_Z;
+	int numSlices = CHUNK_SECTION_BLOCKS_TALL_Z;
+	int sizeU = CHUNK_BLOCKS_WIDE_X;
+	int sizeV = CHUNK_BLOCKS_DEEP_Y;
+	if (face == BLOCK_FACE_NORTH || face == BLOCK_FACE_SOUTH)
+	{
+		numSlices = CHUNK_BLOCKS_DEEP_Y;
+		sizeV = CHUNK_SECTION_BLOCKS_TALL_Z;
+	}
+	else if (face == BLOCK_FACE_EAST || face == BLOCK_FACE_WEST)
+	{
+		numSlices = CHUNK_BLOCKS_WIDE_X;
+		sizeU = CHUNK_BLOCKS_DEEP_Y;
+		sizeV = CHUNK_SECTION_BLOCKS_TALL_Z;
+	}
+
+	//0 - no face, otherwise (blockType << 8 | packedLight) + 1 so only faces with the same sky and block light merge
+	int faceKeys[NUM_BLOCKS_PER_SECTION];
+	int sliceArea = sizeU * sizeV;
+	if (m_meshInput.m_isMaskCulling)
+	{
+		for (int keyIndex = 0; keyIndex < NUM_BLOCKS_PER_SECTION; ++keyIndex)
+		{
+			faceKeys[keyIndex] = 0;
+		}
+
+		for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; ++columnIndex)
+		{
+			int visibleBits = GetVisibleFaceBitsForSection(face, columnIndex, sectionIndex);
+			for (int blockIndexZ = minZ; visibleBits != 0; ++blockIndexZ, visibleBits >>= 1)
+			{
+				if ((visibleBits & 1) == 0)
+					continue;
+
+				IntVector3 blockCoords = Chunk::GetBlockCoordsForBlockIndex(columnIndex + (blockIndexZ * CHUNK_BLOCKS_PER_LAYER));
+				int paddedIndex = GetPaddedIndexForBlockCoords(blockCoords);
+				unsigned char blockType = m_meshInput.m_paddedBlocks[paddedIndex].m_blockType;
+				int packedLight = m_meshInput.m_paddedBlocks[paddedIndex + PADDED_NEIGHBOR_OFFSETS[face]].GetPackedLight();
+				faceKeys[GetFaceKeyIndexForBlockCoords(face, blockCoords, minZ, sizeU, sliceArea)] = ((blockType << FACE_KEY_BLOCK_TYPE_SHIFT) | packedLight) + 1;
+			}
+		}
+	}
+	else
+	{
+		for (int sliceIndex = 0; sliceIndex < numSlices; ++sliceIndex)
+		{
+			for (int indexV = 0; indexV < sizeV; ++indexV)
+			{
+				for (int indexU = 0; indexU < sizeU; ++indexU)
+				{
+					int paddedIndex = GetPaddedIndexForBlockCoords(GetBlockCoordsForFaceSlice(face, sliceIndex, indexU, indexV, minZ));
+					unsigned char blockType = m_meshInput.m_paddedBlocks[paddedIndex].m_blockType;
+					int faceKey = 0;
+					if (blockType != BLOCK_TYPE_AIR)
+					{
+						int packedLight = CalcFacePackedLight(paddedIndex, face);
+						if (packedLight != FACE_HIDDEN)
+							faceKey = ((blockType << FACE_KEY_BLOCK_TYPE_SHIFT) | packedLight) + 1;
+					}
+					faceKeys[(sliceIndex * sliceArea) + indexU + (indexV * sizeU)] = faceKey;
+				}
+			}
+		}
+	}
+
+	for (int sliceIndex = 0; sliceIndex < numSlices; ++sliceIndex)
+	{
+		int* sliceKeys = &faceKeys[sliceIndex * sliceArea];
+		for (int indexV = 0; indexV < sizeV; ++indexV)
+		{
+			for (int indexU = 0; indexU < sizeU; ++indexU)
+			{
+				int faceKey = sliceKeys[indexU + (indexV * sizeU)];
+				if (faceKey == 0)
+					continue;
+
+				int width = 1;
+				while (indexU + width < sizeU && sliceKeys[indexU + width + (indexV * sizeU)] == faceKey)
+				{
+					++width;
+				}
+
+				int height = 1;
+				bool canGrow = true;
+				while (canGrow && indexV + height < sizeV)
+				{
+					for (int rowIndexU = indexU; rowIndexU < indexU + width; ++rowIndexU)
+					{
+						if (sliceKeys[rowIndexU + ((indexV + height) * sizeU)] != faceKey)
+						{
+							canGrow = false;
+							break;
+						}
+					}
+					if (canGrow)
+						++height;
+				}
+
+				for (int clearIndexV = indexV; clearIndexV < indexV + height; ++clearIndexV)
+				{
+					for (int clearIndexU = indexU; clearIndexU < indexU + width; ++clearIndexU)
+					{
+						sliceKeys[clearIndexU + (clearIndexV * sizeU)] = 0;
+					}
+				}
+
+				unsigned char blockType = (unsigned char) ((faceKey - 1) >> FACE_KEY_BLOCK_TYPE_SHIFT);
+				int packedLight = (faceKey - 1) & MASK_PACKED_LIGHT;
+				IntVector3 mins = GetBlockCoordsForFaceSlice(face, sliceIndex, indexU, indexV, minZ);
+				IntVector3 maxs = GetBlockCoordsForFaceSlice(face, sliceIndex + 1, indexU + width, indexV + height, minZ);
+				AppendFaceQuad(chunkVertexes, face, mins, maxs, GetTileIndexForFace(blockType, face), packedLight);
+			}
+		}
+	}
+}
+
+void ChunkMeshBuilder::AppendLODQuads(std::vector< ChunkVertex >& chunkVertexes, int sectionIndex) const
+{
+	//downsample the section into cells with a one cell border, then emit one quad per exposed cell face
+	int cellSize = 1 << m_meshInput.m_lod;
+	int cellsWide = CHUNK_BLOCKS_WIDE_X / cellSize;
+	int cellsTall = CHUNK_SECTION_BLOCKS_TALL_Z / cellSize;
+	int paddedCellsWide = cellsWide + 2;
+	int paddedCellsPerLayer = paddedCellsWide * paddedCellsWide;
+	int minZ = sectionIndex * CHUNK_SECTION_BLOCKS_TALL_Z;
+
+	Block cells[LOD_MAX_PADDED_CELLS];
+	for (int cellZ = -1; cellZ <= cellsTall; ++cellZ)
+	{
+		for (int cellY = -1; cellY <= cellsWide; ++cellY)
+		{
+			for (int cellX = -1; cellX <= cellsWide; ++cellX)
+			{
+				int cellIndex = (cellX + 1) + ((cellY + 1) * paddedCellsWide) + ((cellZ + 1) * paddedCellsPerLayer);
+				cells[cellIndex] = CalcLODCell(IntVector3(cellX * cellSize, cellY * cellSize, minZ + (cellZ * cellSize)), cellSize);
+			}
+		}
+	}
+
+	const int cellNeighborOffsets[BLOCK_FACE_SIZE] = { -paddedCellsPerLayer, paddedCellsPerLayer, paddedCellsWide, -paddedCellsWide, 1, -1 };
+	for (int cellZ = 0; cellZ < cellsTall; ++cellZ)
+	{
+		for (int cellY = 0; cellY < cellsWide; ++cellY)
+		{
+			for (int cellX = 0; cellX < cellsWide; ++cellX)
+			{
+				int cellIndex = (cellX + 1) + ((cellY + 1) * paddedCellsWide) + ((cellZ + 1) * paddedCellsPerLayer);
+				unsigned char blockType = cells[cellIndex].m_blockType;
+				if (blockType == BLOCK_TYPE_AIR)
+					continue;
+
+				IntVector3 cellMins(cellX * cellSize, cellY * cellSize, minZ + (cellZ * cellSize));
+				IntVector3 cellMaxs(cellMins.x + cellSize, cellMins.y + cellSize, cellMins.z + cellSize);
+				for (int faceIndex = 0; faceIndex < BLOCK_FACE_SIZE; ++faceIndex)
+				{
+					const Block& neighbor = cells[cellIndex + cellNeighborOffsets[faceIndex]];
+					if (neighbor.GetIsOpaque())
+						continue;
+
+					BlockFace face = (BlockFace) faceIndex;
+					AppendFaceQuad(chunkVertexes, face, cellMins, cellMaxs, GetTileIndexForFace(blockType, face), neighbor.GetPackedLight());
+				}
+			}
+		}
+	}
+}
+
+Block ChunkMeshBuilder::CalcLODCell(const IntVector3& blockMins, int cellSize) const
+{
+	//cells past the chunk or world edge only cover the one block of padding, so clamp to it
+	IntVector3 mins = blockMins;
+	IntVector3 maxs(blockMins.x + cellSize, blockMins.y + cellSize, blockMins.z + cellSize);
+	if (mins.x < -1)
+		mins.x = -1;
+	if (mins.y < -1)
+		mins.y = -1;
+	if (mins.z < -1)
+		mins.z = -1;
+	if (maxs.x > CHUNK_BLOCKS_WIDE_X + 1)
+		maxs.x = CHUNK_BLOCKS_WIDE_X + 1;
+	if (maxs.y > CHUNK_BLOCKS_DEEP_Y + 1)
+		maxs.y = CHUNK_BLOCKS_DEEP_Y + 1;
+	if (maxs.z > CHUNK_BLOCKS_TALL_Z + 1)
+		maxs.z = CHUNK_BLOCKS_TALL_Z + 1;
+
+	int numBlocks = 0;
+	int numOpaqueBlocks = 0;
+	int topBlockZ = -2;
+	unsigned char topBlockType = BLOCK_TYPE_AIR;
+	int maxSkyLightLevel = 0;
+	int maxLightLevel = 0;
+	for (int blockZ = mins.z; blockZ < maxs.z; ++blockZ)
+	{
+		for (int blockY = mins.y; blockY < maxs.y; ++blockY)
+		{
+			for (int blockX = mins.x; blockX < maxs.x; ++blockX)
+			{
+				const Block& block = m_meshInput.m_paddedBlocks[GetPaddedIndexForBlockCoords(IntVector3(blockX, blockY, blockZ))];
+				++numBlocks;
+				if (block.GetIsOpaque())
+					++numOpaqueBlocks;
+				else
+				{
+					if (block.GetSkyLightLevel() > maxSkyLightLevel)
+						maxSkyLightLevel = block.GetSkyLightLevel();
+					if (block.GetLightLevel() > maxLightLevel)
+						maxLightLevel = block.GetLightLevel();
+				}
+
+				//the top block decides the look of the cell, so grass stays on top of dirt
+				if (block.m_blockType != BLOCK_TYPE_AIR && blockZ > topBlockZ)
+				{
+					topBlockZ = blockZ;
+					topBlockType = block.m_blockType;
+				}
+			}
+		}
+	}
+
+	//a cell is solid when at least half of it is, it takes the brightest light of its open blocks
+	bool isOpaque = numOpaqueBlocks * 2 >= numBlocks;
+	Block cell(BLOCK_TYPE_AIR, false, false);
+	if (isOpaque)
+		cell = Block(topBlockType, true, true);
+	cell.SetSkyLightLevel(maxSkyLightLevel);
+	cell.SetLightLevel(maxLightLevel);
+	return cell;
+}
+
+void ChunkMeshBuilder::AppendFaceQuad(std::vector< ChunkVertex >& chunkVertexes, BlockFace face, const IntVector3& mins, const IntVector3& maxs, unsigned char tileIndex, int packedLight) const
+{
+	//maxs is exclusive, a single block face is mins to mins + 1 on every axis
+	//the tile repeats once per block along the axes its u and v run on, so merged and LOD faces keep the block sized texture
+	IntVector3 size(maxs.x - mins.x, maxs.y - mins.y, maxs.z - mins.z);
+	IntVector2 tileRepeats(size.y, size.z);
+	if (face == BLOCK_FACE_DOWN)
+		tileRepeats = IntVector2(size.x, size.y);
+	else if (face == BLOCK_FACE_UP)
+		tileRepeats = IntVector2(size.y, size.x);
+	else if (face == BLOCK_FACE_NORTH || face == BLOCK_FACE_SOUTH)
+		tileRepeats = IntVector2(size.x, size.z);
+
+	switch (face)
+	{
+	case BLOCK_FACE_DOWN:
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, mins.y, mins.z), face, TEX_CORNER_MAXS_X_MINS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, maxs.y, mins.z), face, TEX_CORNER_MAXS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, maxs.y, mins.z), face, TEX_CORNER_MINS_X_MAXS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, mins.y, mins.z), face, TEX_CORNER_MINS, tileIndex, packedLight, tileRepeats));
+		break;
+	case BLOCK_FACE_UP:
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, mins.y, maxs.z), face, TEX_CORNER_MAXS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, mins.y, maxs.z), face, TEX_CORNER_MAXS_X_MINS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, maxs.y, maxs.z), face, TEX_CORNER_MINS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, maxs.y, maxs.z), face, TEX_CORNER_MINS_X_MAXS_Y, tileIndex, packedLight, tileRepeats));
+		break;
+	case BLOCK_FACE_NORTH:
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, maxs.y, mins.z), face, TEX_CORNER_MINS_X_MAXS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, maxs.y, maxs.z), face, TEX_CORNER_MINS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, maxs.y, maxs.z), face, TEX_CORNER_MAXS_X_MINS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, maxs.y, mins.z), face, TEX_CORNER_MAXS, tileIndex, packedLight, tileRepeats));
+		break;
+	case BLOCK_FACE_SOUTH:
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, mins.y, mins.z), face, TEX_CORNER_MINS_X_MAXS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, mins.y, mins.z), face, TEX_CORNER_MAXS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, mins.y, maxs.z), face, TEX_CORNER_MAXS_X_MINS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, mins.y, maxs.z), face, TEX_CORNER_MINS, tileIndex, packedLight, tileRepeats));
+		break;
+	case BLOCK_FACE_EAST:
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, mins.y, mins.z), face, TEX_CORNER_MAXS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, maxs.y, mins.z), face, TEX_CORNER_MINS_X_MAXS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, maxs.y, maxs.z), face, TEX_CORNER_MINS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(maxs.x, mins.y, maxs.z), face, TEX_CORNER_MAXS_X_MINS_Y, tileIndex, packedLight, tileRepeats));
+		break;
+	case BLOCK_FACE_WEST:
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, mins.y, mins.z), face, TEX_CORNER_MAXS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, mins.y, maxs.z), face, TEX_CORNER_MAXS_X_MINS_Y, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, maxs.y, maxs.z), face, TEX_CORNER_MINS, tileIndex, packedLight, tileRepeats));
+		chunkVertexes.push_back(ChunkVertex(IntVector3(mins.x, maxs.y, mins.z), face, TEX_CORNER_MINS_X_MAXS_Y, tileIndex, packedLight, tileRepeats));
+		break;
+	default:
+		break;
+	}
+}
+
+int ChunkMeshBuilder::CalcFacePackedLight(int paddedIndex, BlockFace face) const
+{
+	//the padding is open sky above and below the world and opaque where a neighbor chunk is not loaded
+	const Block& neighbor = m_meshInput.m_paddedBlocks[paddedIndex + PADDED_NEIGHBOR_OFFSETS[face]];
+	if (neighbor.GetIsOpaque())
+		return FACE_HIDDEN;
+	return neighbor.GetPackedLight();
+}
+
+int ChunkMeshBuilder::GetPaddedIndexForBlockCoords(const IntVector3& blockCoords)
+{
+	return (blockCoords.x + 1) + ((blockCoords.y + 1) * PADDED_BLOCKS_WIDE_X) + ((blockCoords.z + 1) * PADDED_BLOCKS_PER_LAYER);
+}
+
+IntVector3 ChunkMeshBuilder::GetBlockCoordsForFaceSlice(BlockFace face, int sliceIndex, int indexU, int indexV, int minZ) const
+{
+	if (face == BLOCK_FACE_NORTH || face == BLOCK_FACE_SOUTH)
+		return IntVector3(indexU, sliceIndex, minZ + indexV);
+	else if (face == BLOCK_FACE_EAST || face == BLOCK_FACE_WEST)
+		return IntVector3(sliceIndex, indexU, minZ + indexV);
+	else
+		return IntVector3(indexU, indexV, minZ + sliceIndex);
+}
+
+int ChunkMeshBuilder::GetFaceKeyIndexForBlockCoords(BlockFace face, const IntVector3& blockCoords, int minZ, int sizeU, int sliceArea) const
+{
+	//inverse of GetBlockCoordsForFaceSlice, flattened to slice * area + u + v * sizeU
+	if (face == BLOCK_FACE_NORTH || face == BLOCK_FACE_SOUTH)
+		return (blockCoords.y * sliceArea) + blockCoords.x + ((blockCoords.z - minZ) * sizeU);
+	else if (face == BLOCK_FACE_EAST || face == BLOCK_FACE_WEST)
+		return (blockCoords.x * sliceArea) + blockCoords.y + ((blockCoords.z - minZ) * sizeU);
+	else
+		return ((blockCoords.z - minZ) * sliceArea) + blockCoords.x + (blockCoords.y * sizeU);
+}
+
+unsigned char ChunkMeshBuilder::GetTileIndexForFace(unsigned char blockType, BlockFace face) const
+{
+	return m_meshInput.m_blockDefinitions[blockType]->GetTileIndexForFace(face);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+#include "Game/Block.hpp"
+#include "Game/BlockDefinition.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/ChunkVertex.hpp"
+#include "Game/Chunk.hpp"
+#include "Engine/Math/IntVector2.hpp"
+#include <vector>
+#include <stdint.h>
+
+class IntVector3;
+
+const int FACE_HIDDEN = -1;
+const int FACE_KEY_BLOCK_TYPE_SHIFT = BITS_LIGHT * 2;
+const int PADDED_BLOCKS_WIDE_X = CHUNK_BLOCKS_WIDE_X + 2;
+const int PADDED_BLOCKS_DEEP_Y = CHUNK_BLOCKS_DEEP_Y + 2;
+const int PADDED_BLOCKS_TALL_Z = CHUNK_BLOCKS_TALL_Z + 2;
+const int PADDED_BLOCKS_PER_LAYER = PADDED_BLOCKS_WIDE_X * PADDED_BLOCKS_DEEP_Y;
+const int NUM_PADDED_BLOCKS = PADDED_BLOCKS_PER_LAYER * PADDED_BLOCKS_TALL_Z;
+const int LOD_MAX_PADDED_CELLS_WIDE = (CHUNK_BLOCKS_WIDE_X / 2) + 2;
+const int LOD_MAX_PADDED_CELLS_TALL = (CHUNK_SECTION_BLOCKS_TALL_Z / 2) + 2;
+const int LOD_MAX_PADDED_CELLS = LOD_MAX_PADDED_CELLS_WIDE * LOD_MAX_PADDED_CELLS_WIDE * LOD_MAX_PADDED_CELLS_TALL;
+
+//immutable copy of a chunk and a one block border of its neighbors, safe to mesh on any thread
+struct ChunkMeshInput
+{
+	IntVector2 m_chunkCoords;
+	int m_meshJobID;
+	bool m_isGreedyMeshing;
+	bool m_isMaskCulling;
+	ChunkLOD m_lod;
+	int m_dirtySectionMask; //bit per section that needs a new mesh
+	int m_previousNumVertexes[NUM_SECTIONS_PER_CHUNK]; //sizes the section vertex storage up front
+	bool m_isSectionAllAir[NUM_SECTIONS_PER_CHUNK];
+	bool m_isSectionAllOpaque[NUM_SECTIONS_PER_CHUNK];
+	bool m_isNeighborSectionAllOpaque[BLOCK_FACE_SIZE][NUM_SECTIONS_PER_CHUNK]; //lateral faces only
+	BlockDefinition* const* m_blockDefinitions;
+	Block m_paddedBlocks[NUM_PADDED_BLOCKS]; //18x18x130, block (0,0,0) of the chunk is at padded (1,1,1)
+};
+
+struct ChunkMeshResult
+{
+	IntVector2 m_chunkCoords;
+	int m_meshJobID;
+	int m_sectionMask; //sections that were meshed, the rest keep their current mesh
+	int m_numAllocations; //buffers allocated or regrown for this remesh, 0 once the arena is warm
+	bool m_isRecolorable; //one quad per block face, so light can be updated without remeshing
+	std::vector< ChunkVertex > m_sectionVertexes[NUM_SECTIONS_PER_CHUNK];
+
+	int CalcNumVertexes() const;
+	int CalcNumIndexes() const;
+};
+
+//one bit per block of a 128 tall column, bit z is block z
+struct ColumnMask
+{
+	uint64_t m_lowBits;
+	uint64_t m_highBits;
+};
+
+class ChunkMeshBuilder
+{
+public:
+	ChunkMeshBuilder(const ChunkMeshInput& meshInput);
+	~ChunkMeshBuilder();
+
+	void BuildMesh(ChunkMeshResult& meshResult) const;
+
+	static int GetPaddedIndexForBlockCoords(const IntVector3& blockCoords);
+
+private:
+	const ChunkMeshInput& m_meshInput;
+	ColumnMask m_visibleFaceMasks[BLOCK_FACE_SIZE][CHUNK_BLOCKS_PER_LAYER]; //only filled when mask culling
+
+	void InitVisibleFaceMasks();
+	int GetVisibleFaceBitsForSection(BlockFace face, int columnIndex, int sectionIndex) const;
+
+	bool IsSectionHidden(int sectionIndex) const;
+	void BuildSectionMesh(std::vector< ChunkVertex >& chunkVertexes, int sectionIndex) const;
+	void AppendPerFaceQuads(std::vector< ChunkVertex >& chunkVertexes, int sectionIndex) const;
+	void AppendGreedyQuads(std::vector< ChunkVertex >& chunkVertexes, BlockFace face, int sectionIndex) const;
+	void AppendLODQuads(std::vector< ChunkVertex >& chunkVertexes, int sectionIndex) const;
+	Block CalcLODCell(const IntVector3& blockMins, int cellSize) const;
+	void AppendFaceQuad(std::vector< ChunkVertex >& chunkVertexes, BlockFace face, const IntVector3& mins, const IntVector3& maxs, unsigned char tileIndex, int packedLight) const;
+	int CalcFacePackedLight(int paddedIndex, BlockFace face) const;
+	IntVector3 GetBlockCoordsForFaceSlice(BlockFace face, int sliceIndex, int indexU, int indexV, int minZ) const;
+	int GetFaceKeyIndexForBlockCoords(BlockFace face, const IntVector3& blockCoords, int minZ, int sizeU, int sliceArea) const;
+	unsigned char GetTileIndexForFace(unsigned char blockType, BlockFace face) const;
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "Game/ChunkMeshCache.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+ChunkMeshCache::ChunkMeshCache()
+	: m_numHits(0)
+	, m_numMisses(0)
+{
+}
+
+void ChunkMeshCache::SaveChunkMesh(const Chunk& chunk, const ChunkMeshInput& meshInput)
+{
+	//a pending remesh or recolor means the current mesh does not match the blocks being hashed
+	if (chunk.GetState() != CHUNK_STATE_MESHED)
+		return;
+	bool isRecolorable = chunk.m_sections[0].m_canRecolor;
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		const ChunkSection& section = chunk.m_sections[sectionIndex];
+		if (section.m_isDirty || section.m_isLightDirty || section.m_latestMeshJobID != section.m_appliedMeshJobID || section.m_canRecolor != isRecolorable)
+			return;
+	}
+
+	std::vector< unsigned char > buffer;
+	buffer.push_back(MESH_CACHE_FILE_VERSION);
+	buffer.push_back(isRecolorable ? 1 : 0);
+	uint64_t contentHash = CalcContentHash(meshInput);
+	AppendBytes(buffer, (const unsigned char*) &contentHash, (int) sizeof(contentHash));
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		const std::vector< ChunkVertex >& vertexes = chunk.m_sections[sectionIndex].m_vertexes;
+		int numVertexes = (int) vertexes.size();
+		AppendBytes(buffer, (const unsigned char*) &numVertexes, (int) sizeof(numVertexes));
+		if (numVertexes > 0)
+			AppendBytes(buffer, (const unsigned char*) &vertexes[0], numVertexes * (int) sizeof(ChunkVertex));
+	}
+	SaveBinaryFileFromBuffer(GetFileNameForChunkCoords(meshInput.m_chunkCoords), buffer);
+}
+
+bool ChunkMeshCache::LoadChunkMesh(const ChunkMeshInput& meshInput, ChunkMeshResult& meshResult)
+{
+	//only a remesh of every section can be replaced by the cache
+	if (meshInput.m_dirtySectionMask != (1 << NUM_SECTIONS_PER_CHUNK) - 1)
+		return false;
+
+	std::vector< unsigned char > buffer;
+	int readIndex = 2;
+	uint64_t contentHash = 0;
+	if (!LoadBinaryFileToBuffer(GetFileNameForChunkCoords(meshInput.m_chunkCoords), buffer) || (int) buffer.size() < readIndex || buffer[0] != MESH_CACHE_FILE_VERSION
+		|| !ReadBytes(buffer, readIndex, (unsigned char*) &contentHash, (int) sizeof(contentHash)) || contentHash != CalcContentHash(meshInput))
+	{
+		++m_numMisses;
+		return false;
+	}
+
+	for (int sectionIndex = 0; sectionIndex < NUM_SECTIONS_PER_CHUNK; ++sectionIndex)
+	{
+		std::vector< ChunkVertex >& vertexes = meshResult.m_sectionVertexes[sectionIndex];
+		int numVertexes = 0;
+		if (!ReadBytes(buffer, readIndex, (unsigned char*) &numVertexes, (int) sizeof(numVertexes)) || numVertexes < 0 || numVertexes > MAX_QUADS_PER_SECTION * NUM_VERTEXES_PER_QUAD)
+		{
+			++m_numMisses;
+			return false;
+		}
+
+		vertexes.resize(numVertexes);
+		if (numVertexes > 0 && !ReadBytes(buffer, readIndex, (unsigned char*) &vertexes[0], numVertexes * (int) sizeof(ChunkVertex)))
+		{
+			++m_numMisses;
+			return false;
+		}
+	}
+
+	meshResult.m_chunkCoords = meshInput.m_chunkCoords;
+	meshResult.m_meshJobID = meshInput.m_meshJobID;
+	meshResult.m_sectionMask = meshInput.m_dirtySectionMask;
+	meshResult.m_isRecolorable = buffer[1] != 0;
+	++m_numHits;
+	return true;
+}
+
+uint64_t ChunkMeshCache::CalcContentHash(const ChunkMeshInput& meshInput)
+{
+	//FNV-1a over everything the mesh depends on, the lighting dirty flag does not change a face
+	uint64_t contentHash = FNV_OFFSET_BASIS;
+	contentHash = (contentHash ^ (uint64_t) meshInput.m_lod) * FNV_PRIME;
+	contentHash = (contentHash ^ (uint64_t) (meshInput.m_isGreedyMeshing ? 1 : 0)) * FNV_PRIME;
+	for (int paddedIndex = 0; paddedIndex < NUM_PADDED_BLOCKS; ++paddedIndex)
+	{
+		const Block& block = meshInput.m_paddedBlocks[paddedIndex];
+		contentHash = (contentHash ^ block.m_blockType) * FNV_PRIME;
+		contentHash = (contentHash ^ (block.m_lightingAndFlags & ~MASK_IS_LIGHTING_DIRTY)) * FNV_PRIME;
+		contentHash = (contentHash ^ block.m_skyLightLevel) * FNV_PRIME;
+	}
+	return contentHash;
+}
+
+int ChunkMeshCache::GetNumHits() const
+{
+	return m_numHits;
+}
+
+int ChunkMeshCache::GetNumMisses() const
+{
+	return m_numMisses;
+}
+
+std::string ChunkMeshCache::GetFileNameForChunkCoords(const IntVector2& chunkCoords)
+{
+	return Stringf("Data/Saves/Chunk_at_(%i,%i).mesh", chunkCoords.x, chunkCoords.y);
+}
+
+void ChunkMeshCache::AppendBytes(std::vector< unsigned char >& buffer, const unsigned char* bytes, int numBytes)
+{
+	buffer.insert(buffer.end(), bytes, bytes + numBytes);
+}
+
+bool ChunkMeshCache::ReadBytes(const std::vector< unsigned char >& buffer, int& readIndex, unsigned char* bytes, int numBytes)
+{
+	if (readIndex + numBytes > (int) buffer.size())
+		return false;
+
+	for (int byteIndex = 0; byteIndex < numBytes; ++byteIndex)
+	{
+		bytes[byteIndex] = buffer[readIndex + byteIndex];
+	}
+	readIndex += numBytes;
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Game/ChunkMeshBuilder.hpp"
+#include <stdint.h>
+#include <string>
+
+const unsigned char MESH_CACHE_FILE_VERSION = 3;
+
+//keeps the packed mesh of a saved chunk on disk so reloading it unchanged skips meshing
+//a cached mesh is only used when the chunk and its one block border hash the same as when it was saved
+class ChunkMeshCache
+{
+public:
+	ChunkMeshCache();
+
+	void SaveChunkMesh(const Chunk& chunk, const ChunkMeshInput& meshInput);
+	bool LoadChunkMesh(const ChunkMeshInput& meshInput, ChunkMeshResult& meshResult);
+	static uint64_t CalcContentHash(const ChunkMeshInput& meshInput);
+
+	int GetNumHits() const;
+	int GetNumMisses() const;
+
+private:
+	static std::string GetFileNameForChunkCoords(const IntVector2& chunkCoords);
+	static void AppendBytes(std::vector< unsigned char >& buffer, const unsigned char* bytes, int numBytes);
+	static bool ReadBytes(const std::vector< unsigned char >& buffer, int& readIndex, unsigned char* bytes, int numBytes);
+
+	int m_numHits;
+	int m_numMisses;
+};
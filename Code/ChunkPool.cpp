@@ -0,0 +1,117 @@
+#include "Game/ChunkPool.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <new>
+
+ChunkPool::ChunkPool(int capacity, bool isUsingLargePages)
+	: m_storage(nullptr)
+	, m_chunkStride(0)
+	, m_capacity(capacity)
+	, m_numChunksConstructed(0)
+	, m_numChunksInUse(0)
+	, m_peakNumChunksInUse(0)
+	, m_isUsingLargePages(false)
+{
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	int pageSize = (int) systemInfo.dwPageSize;
+	m_chunkStride = (((int) sizeof(Chunk) + pageSize - 1) / pageSize) * pageSize;
+	int storageSize = m_chunkStride * m_capacity;
+
+	//large pages need the lock pages in memory privilege, without it the pool falls back to normal pages
+	int largePageSize = (int) GetLargePageMinimum();
+	if (isUsingLargePages && largePageSize > 0 && EnableLockMemoryPrivilege())
+	{
+		int largeStorageSize = ((storageSize + largePageSize - 1) / largePageSize) * largePageSize;
+		m_storage = (unsigned char*) VirtualAlloc(nullptr, largeStorageSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		m_isUsingLargePages = m_storage != nullptr;
+	}
+	if (m_storage == nullptr)
+		m_storage = (unsigned char*) VirtualAlloc(nullptr, storageSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	ASSERT_OR_DIE(m_storage != nullptr, "Could not allocate the chunk pool");
+
+	m_freeChunks.reserve(m_capacity);
+}
+
+ChunkPool::~ChunkPool()
+{
+	for (int chunkIndex = 0; chunkIndex < m_numChunksConstructed; ++chunkIndex)
+	{
+		Chunk* chunk = (Chunk*) (m_storage + (chunkIndex * m_chunkStride));
+		chunk->~Chunk();
+	}
+	VirtualFree(m_storage, 0, MEM_RELEASE);
+	m_storage = nullptr;
+}
+
+Chunk* ChunkPool::AcquireChunk()
+{
+	Chunk* chunk = nullptr;
+	if (!m_freeChunks.empty())
+	{
+		chunk = m_freeChunks.back();
+		m_freeChunks.pop_back();
+	}
+	else if (m_numChunksConstructed < m_capacity)
+	{
+		chunk = new (m_storage + (m_numChunksConstructed * m_chunkStride)) Chunk();
+		++m_numChunksConstructed;
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	++m_numChunksInUse;
+	if (m_numChunksInUse > m_peakNumChunksInUse)
+		m_peakNumChunksInUse = m_numChunksInUse;
+	return chunk;
+}
+
+void ChunkPool::ReleaseChunk(Chunk* chunk)
+{
+	m_freeChunks.push_back(chunk);
+	--m_numChunksInUse;
+}
+
+bool ChunkPool::HasFreeChunk() const
+{
+	return m_numChunksInUse < m_capacity;
+}
+
+int ChunkPool::GetCapacity() const
+{
+	return m_capacity;
+}
+
+int ChunkPool::GetNumChunksInUse() const
+{
+	return m_numChunksInUse;
+}
+
+int ChunkPool::GetPeakNumChunksInUse() const
+{
+	return m_peakNumChunksInUse;
+}
+
+bool ChunkPool::IsUsingLargePages() const
+{
+	return m_isUsingLargePages;
+}
+
+bool ChunkPool::EnableLockMemoryPrivilege()
+{
+	HANDLE tokenHandle;
+	if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &tokenHandle))
+		return false;
+
+	TOKEN_PRIVILEGES privileges;
+	privileges.PrivilegeCount = 1;
+	privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+	bool isEnabled = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid)
+		&& AdjustTokenPrivileges(tokenHandle, FALSE, &privileges, 0, nullptr, nullptr)
+		&& GetLastError() == ERROR_SUCCESS; //succeeds without the privilege when the account was never granted it
+	CloseHandle(tokenHandle);
+	return isEnabled;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "Game/Chunk.hpp"
+#include <vector>
+
+//a fixed number of chunks in one page aligned allocation, handed out again after they are deactivated
+//each chunk is constructed the first time its storage is used and only reset after that, so it keeps its VBOs too
+class ChunkPool
+{
+public:
+	ChunkPool(int capacity, bool isUsingLargePages);
+	~ChunkPool();
+
+	Chunk* AcquireChunk(); //nullptr when every chunk is in use, the caller resets the chunk it gets
+	void ReleaseChunk(Chunk* chunk);
+
+	bool HasFreeChunk() const;
+	int GetCapacity() const;
+	int GetNumChunksInUse() const;
+	int GetPeakNumChunksInUse() const;
+	bool IsUsingLargePages() const;
+
+private:
+	static bool EnableLockMemoryPrivilege();
+
+	unsigned char* m_storage;
+	int m_chunkStride; //size of a chunk rounded up to whole pages, so every chunk starts on a page
+	int m_capacity;
+	int m_numChunksConstructed;
+	int m_numChunksInUse;
+	int m_peakNumChunksInUse;
+	bool m_isUsingLargePages;
+	std::vector< Chunk* > m_freeChunks;
+};
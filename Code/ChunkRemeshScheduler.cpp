@@ -0,0 +1,99 @@
+#include "Game/ChunkRemeshScheduler.hpp"
+#include <algorithm>
+
+static bool IsLaterRemeshRequest(const ChunkRemeshRequest& first, const ChunkRemeshRequest& second)
+{
+	return first.m_priority > second.m_priority;
+}
+
+ChunkRemeshScheduler::ChunkRemeshScheduler(float secondsPerFrame)
+	: m_secondsPerFrame(secondsPerFrame)
+{
+}
+
+void ChunkRemeshScheduler::QueueChunk(Chunk* chunk)
+{
+	//a chunk dirtied again while it waits keeps its one entry
+	if (chunk == nullptr || chunk->m_isQueuedForRemesh)
+		return;
+
+	chunk->m_isQueuedForRemesh = true;
+	ChunkRemeshRequest request;
+	request.m_chunk = chunk;
+	request.m_priority = 0.f;
+	m_requests.push_back(request);
+	std::push_heap(m_requests.begin(), m_requests.end(), IsLaterRemeshRequest);
+}
+
+void ChunkRemeshScheduler::RemoveChunk(Chunk* chunk)
+{
+	if (!chunk->m_isQueuedForRemesh)
+		return;
+
+	for (int requestIndex = 0; requestIndex < (int) m_requests.size(); ++requestIndex)
+	{
+		if (m_requests[requestIndex].m_chunk == chunk)
+		{
+			m_requests[requestIndex] = m_requests.back();
+			m_requests.pop_back();
+			std::make_heap(m_requests.begin(), m_requests.end(), IsLaterRemeshRequest);
+			break;
+		}
+	}
+	chunk->m_isQueuedForRemesh = false;
+}
+
+void ChunkRemeshScheduler::UpdatePriorities(const Vector3& cameraPos)
+{
+	//only queued chunks are rekeyed, the camera moves every frame so priorities are never stale for long
+	for (int requestIndex = 0; requestIndex < (int) m_requests.size(); ++requestIndex)
+	{
+		m_requests[requestIndex].m_priority = CalcPriority(m_requests[requestIndex].m_chunk, cameraPos);
+	}
+	std::make_heap(m_requests.begin(), m_requests.end(), IsLaterRemeshRequest);
+}
+
+Chunk* ChunkRemeshScheduler::GetNextChunk() const
+{
+	if (m_requests.empty())
+		return nullptr;
+	return m_requests.front().m_chunk;
+}
+
+void ChunkRemeshScheduler::PopNextChunk()
+{
+	if (m_requests.empty())
+		return;
+
+	m_requests.front().m_chunk->m_isQueuedForRemesh = false;
+	std::pop_heap(m_requests.begin(), m_requests.end(), IsLaterRemeshRequest);
+	m_requests.pop_back();
+}
+
+bool ChunkRemeshScheduler::IsEmpty() const
+{
+	return m_requests.empty();
+}
+
+int ChunkRemeshScheduler::GetNumQueuedChunks() const
+{
+	return (int) m_requests.size();
+}
+
+void ChunkRemeshScheduler::SetSecondsPerFrame(float secondsPerFrame)
+{
+	m_secondsPerFrame = secondsPerFrame;
+}
+
+float ChunkRemeshScheduler::GetSecondsPerFrame() const
+{
+	return m_secondsPerFrame;
+}
+
+float ChunkRemeshScheduler::CalcPriority(Chunk* chunk, const Vector3& cameraPos) const
+{
+	float priority = cameraPos.CalcDistanceToVector(chunk->GetChunkCenterWorldCoords());
+	if (!chunk->IsVisible())
+		priority += REMESH_NOT_VISIBLE_DISTANCE_PENALTY;
+	return priority;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Game/Chunk.hpp"
+#include "Engine/Math/Vector3.hpp"
+#include <vector>
+
+const float REMESH_NOT_VISIBLE_DISTANCE_PENALTY = 256.f; //chunks behind the camera wait for every visible chunk in range
+
+struct ChunkRemeshRequest
+{
+	Chunk* m_chunk;
+	float m_priority; //lower is sooner
+};
+
+//each chunk that needs a remesh or recolor is queued once, nearest visible chunks first
+class ChunkRemeshScheduler
+{
+public:
+	ChunkRemeshScheduler(float secondsPerFrame);
+
+	void QueueChunk(Chunk* chunk);
+	void RemoveChunk(Chunk* chunk);
+	void UpdatePriorities(const Vector3& cameraPos);
+	Chunk* GetNextChunk() const;
+	void PopNextChunk();
+	bool IsEmpty() const;
+	int GetNumQueuedChunks() const;
+
+	void SetSecondsPerFrame(float secondsPerFrame);
+	float GetSecondsPerFrame() const;
+
+private:
+	float CalcPriority(Chunk* chunk, const Vector3& cameraPos) const;
+
+	std::vector< ChunkRemeshRequest > m_requests; //min heap on priority
+	float m_secondsPerFrame;
+};
@@ -0,0 +1,321 @@
+#include "Game/ChunkTileShader.hpp"
+#include "Game/ChunkVertex.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <gl/gl.h>
+#include <math.h>
+#include <stddef.h>
+#include <vector>
+
+//gl/gl.h stops at OpenGL 1.1, the shader and buffer entry points are looked up from the driver
+typedef char GLchar;
+typedef ptrdiff_t GLsizeiptr;
+typedef GLuint (APIENTRY* CreateShaderFunction)(GLenum shaderType);
+typedef void (APIENTRY* ShaderSourceFunction)(GLuint shaderID, GLsizei count, const GLchar* const* sources, const GLint* lengths);
+typedef void (APIENTRY* CompileShaderFunction)(GLuint shaderID);
+typedef void (APIENTRY* GetShaderivFunction)(GLuint shaderID, GLenum parameterName, GLint* out_parameter);
+typedef void (APIENTRY* DeleteShaderFunction)(GLuint shaderID);
+typedef GLuint (APIENTRY* CreateProgramFunction)();
+typedef void (APIENTRY* AttachShaderFunction)(GLuint programID, GLuint shaderID);
+typedef void (APIENTRY* LinkProgramFunction)(GLuint programID);
+typedef void (APIENTRY* GetProgramivFunction)(GLuint programID, GLenum parameterName, GLint* out_parameter);
+typedef void (APIENTRY* DeleteProgramFunction)(GLuint programID);
+typedef void (APIENTRY* UseProgramFunction)(GLuint programID);
+typedef GLint (APIENTRY* GetUniformLocationFunction)(GLuint programID, const GLchar* name);
+typedef void (APIENTRY* Uniform1iFunction)(GLint location, GLint value);
+typedef void (APIENTRY* Uniform1fFunction)(GLint location, GLfloat value);
+typedef void (APIENTRY* Uniform2fFunction)(GLint location, GLfloat x, GLfloat y);
+typedef void (APIENTRY* BindAttribLocationFunction)(GLuint programID, GLuint attributeIndex, const GLchar* name);
+typedef void (APIENTRY* EnableVertexAttribArrayFunction)(GLuint attributeIndex);
+typedef void (APIENTRY* DisableVertexAttribArrayFunction)(GLuint attributeIndex);
+typedef void (APIENTRY* VertexAttribPointerFunction)(GLuint attributeIndex, GLint size, GLenum type, GLboolean isNormalized, GLsizei stride, const void* offset);
+typedef void (APIENTRY* GenBuffersFunction)(GLsizei count, GLuint* out_bufferIDs);
+typedef void (APIENTRY* DeleteBuffersFunction)(GLsizei count, const GLuint* bufferIDs);
+typedef void (APIENTRY* BindBufferFunction)(GLenum target, GLuint bufferID);
+typedef void (APIENTRY* BufferDataFunction)(GLenum target, GLsizeiptr numBytes, const void* data, GLenum usage);
+
+const GLenum SHADER_TYPE_FRAGMENT = 0x8B30;
+const GLenum SHADER_TYPE_VERTEX = 0x8B31;
+const GLenum SHADER_COMPILE_STATUS = 0x8B81;
+const GLenum PROGRAM_LINK_STATUS = 0x8B82;
+const GLenum BUFFER_TARGET_ARRAY = 0x8892;
+const GLenum BUFFER_TARGET_ELEMENT_ARRAY = 0x8893;
+const GLenum BUFFER_USAGE_STATIC_DRAW = 0x88E4;
+const GLuint PACKED_VERTEX_ATTRIBUTE = 0; //aliases gl_Vertex, so it is the attribute that makes each vertex
+const float TILE_INSET_TEXELS = 0.5f;
+
+static CreateShaderFunction s_createShader = nullptr;
+static ShaderSourceFunction s_shaderSource = nullptr;
+static CompileShaderFunction s_compileShader = nullptr;
+static GetShaderivFunction s_getShaderiv = nullptr;
+static DeleteShaderFunction s_deleteShader = nullptr;
+static CreateProgramFunction s_createProgram = nullptr;
+static AttachShaderFunction s_attachShader = nullptr;
+static LinkProgramFunction s_linkProgram = nullptr;
+static GetProgramivFunction s_getProgramiv = nullptr;
+static DeleteProgramFunction s_deleteProgram = nullptr;
+static UseProgramFunction s_useProgram = nullptr;
+static GetUniformLocationFunction s_getUniformLocation = nullptr;
+static Uniform1iFunction s_uniform1i = nullptr;
+static Uniform1fFunction s_uniform1f = nullptr;
+static Uniform2fFunction s_uniform2f = nullptr;
+static BindAttribLocationFunction s_bindAttribLocation = nullptr;
+static EnableVertexAttribArrayFunction s_enableVertexAttribArray = nullptr;
+static DisableVertexAttribArrayFunction s_disableVertexAttribArray = nullptr;
+static VertexAttribPointerFunction s_vertexAttribPointer = nullptr;
+static GenBuffersFunction s_genBuffers = nullptr;
+static DeleteBuffersFunction s_deleteBuffers = nullptr;
+static BindBufferFunction s_bindBuffer = nullptr;
+static BufferDataFunction s_bufferData = nullptr;
+static bool s_areFunctionsLoaded = false;
+
+//the two words of a ChunkVertex arrive as floats, both stay under 2^24 so they are exact and the fields come out with floor and mod
+//the divisors follow the bit layout in ChunkVertex.cpp: x 5, y 5, z 8, face 3, corner 2 and tile 8, light 8, repeats 4 and 4
+static const char* CHUNK_TILE_VERTEX_SHADER =
+	"attribute vec2 a_packedVertex;\n"
+	"uniform float u_outdoorLightLevel;\n"
+	"varying vec2 v_tileIndex;\n"
+	"varying vec2 v_tileCoords;\n"
+	"void main()\n"
+	"{\n"
+	"	float positionAndFace = a_packedVertex.x;\n"
+	"	vec3 position = vec3(mod(positionAndFace, 32.0), mod(floor(positionAndFace / 32.0), 32.0), mod(floor(positionAndFace / 1024.0), 256.0));\n"
+	"	gl_Position = gl_ModelViewProjectionMatrix * vec4(position, 1.0);\n"
+	"\n"
+	"	float texCorner = mod(floor(positionAndFace / 2097152.0), 4.0);\n"
+	"	vec2 corner = vec2(step(0.5, texCorner) - step(2.5, texCorner), step(1.5, texCorner));\n"
+	"	float tileAndLight = a_packedVertex.y;\n"
+	"	float tile = mod(tileAndLight, 256.0);\n"
+	"	vec2 tileRepeats = vec2(mod(floor(tileAndLight / 65536.0), 16.0), mod(floor(tileAndLight / 1048576.0), 16.0)) + vec2(1.0);\n"
+	"	v_tileIndex = vec2(mod(tile, 16.0), floor(tile / 16.0));\n"
+	"	v_tileCoords = corner * tileRepeats;\n"
+	"\n"
+	"	float packedLight = mod(floor(tileAndLight / 256.0), 256.0);\n"
+	"	float skyLightLevel = (floor(packedLight / 16.0) * u_outdoorLightLevel) / 15.0;\n"
+	"	float grayScale = max(skyLightLevel, mod(packedLight, 16.0)) / 15.0;\n"
+	"	gl_FrontColor = vec4(grayScale, grayScale, grayScale, 1.0);\n"
+	"}\n";
+
+//fract() jumps at every block edge, so the sample is kept half a texel inside the tile and, where the driver allows,
+//the mip level comes from the unwrapped coords instead of the jump
+static const char* CHUNK_TILE_FRAGMENT_SHADER =
+	"#extension GL_ARB_shader_texture_lod : enable\n"
+	"uniform sampler2D u_atlas;\n"
+	"uniform vec2 u_firstTileMins;\n"
+	"uniform vec2 u_tileStep;\n"
+	"uniform vec2 u_tileSize;\n"
+	"uniform vec2 u_tileInset;\n"
+	"varying vec2 v_tileIndex;\n"
+	"varying vec2 v_tileCoords;\n"
+	"void main()\n"
+	"{\n"
+	"	vec2 tileIndex = floor(v_tileIndex + vec2(0.5));\n"
+	"	vec2 tileFraction = clamp(fract(v_tileCoords), u_tileInset, vec2(1.0) - u_tileInset);\n"
+	"	vec2 texCoords = u_firstTileMins + (tileIndex * u_tileStep) + (tileFraction * u_tileSize);\n"
+	"#ifdef GL_ARB_shader_texture_lod\n"
+	"	vec4 texel = texture2DGradARB(u_atlas, texCoords, dFdx(v_tileCoords) * u_tileSize, dFdy(v_tileCoords) * u_tileSize);\n"
+	"#else\n"
+	"	vec4 texel = texture2D(u_atlas, texCoords);\n"
+	"#endif\n"
+	"	gl_FragColor = texel * gl_Color;\n"
+	"}\n";
+
+static bool LoadGLFunctions()
+{
+	//chunks create their buffers before the shader is built, whichever comes first loads everything
+	if (s_areFunctionsLoaded)
+		return true;
+
+	s_createShader = (CreateShaderFunction) wglGetProcAddress("glCreateShader");
+	s_shaderSource = (ShaderSourceFunction) wglGetProcAddress("glShaderSource");
+	s_compileShader = (CompileShaderFunction) wglGetProcAddress("glCompileShader");
+	s_getShaderiv = (GetShaderivFunction) wglGetProcAddress("glGetShaderiv");
+	s_deleteShader = (DeleteShaderFunction) wglGetProcAddress("glDeleteShader");
+	s_createProgram = (CreateProgramFunction) wglGetProcAddress("glCreateProgram");
+	s_attachShader = (AttachShaderFunction) wglGetProcAddress("glAttachShader");
+	s_linkProgram = (LinkProgramFunction) wglGetProcAddress("glLinkProgram");
+	s_getProgramiv = (GetProgramivFunction) wglGetProcAddress("glGetProgramiv");
+	s_deleteProgram = (DeleteProgramFunction) wglGetProcAddress("glDeleteProgram");
+	s_useProgram = (UseProgramFunction) wglGetProcAddress("glUseProgram");
+	s_getUniformLocation = (GetUniformLocationFunction) wglGetProcAddress("glGetUniformLocation");
+	s_uniform1i = (Uniform1iFunction) wglGetProcAddress("glUniform1i");
+	s_uniform1f = (Uniform1fFunction) wglGetProcAddress("glUniform1f");
+	s_uniform2f = (Uniform2fFunction) wglGetProcAddress("glUniform2f");
+	s_bindAttribLocation = (BindAttribLocationFunction) wglGetProcAddress("glBindAttribLocation");
+	s_enableVertexAttribArray = (EnableVertexAttribArrayFunction) wglGetProcAddress("glEnableVertexAttribArray");
+	s_disableVertexAttribArray = (DisableVertexAttribArrayFunction) wglGetProcAddress("glDisableVertexAttribArray");
+	s_vertexAttribPointer = (VertexAttribPointerFunction) wglGetProcAddress("glVertexAttribPointer");
+	s_genBuffers = (GenBuffersFunction) wglGetProcAddress("glGenBuffers");
+	s_deleteBuffers = (DeleteBuffersFunction) wglGetProcAddress("glDeleteBuffers");
+	s_bindBuffer = (BindBufferFunction) wglGetProcAddress("glBindBuffer");
+	s_bufferData = (BufferDataFunction) wglGetProcAddress("glBufferData");
+
+	s_areFunctionsLoaded = s_createShader != nullptr && s_shaderSource != nullptr && s_compileShader != nullptr && s_getShaderiv != nullptr && s_deleteShader != nullptr
+		&& s_createProgram != nullptr && s_attachShader != nullptr && s_linkProgram != nullptr && s_getProgramiv != nullptr && s_deleteProgram != nullptr
+		&& s_useProgram != nullptr && s_getUniformLocation != nullptr && s_uniform1i != nullptr && s_uniform1f != nullptr && s_uniform2f != nullptr
+		&& s_bindAttribLocation != nullptr && s_enableVertexAttribArray != nullptr && s_disableVertexAttribArray != nullptr && s_vertexAttribPointer != nullptr
+		&& s_genBuffers != nullptr && s_deleteBuffers != nullptr && s_bindBuffer != nullptr && s_bufferData != nullptr;
+	return s_areFunctionsLoaded;
+}
+
+static GLuint CompileShader(GLenum shaderType, const char* source)
+{
+	GLuint shaderID = s_createShader(shaderType);
+	s_shaderSource(shaderID, 1, &source, nullptr);
+	s_compileShader(shaderID);
+
+	GLint isCompiled = 0;
+	s_getShaderiv(shaderID, SHADER_COMPILE_STATUS, &isCompiled);
+	if (isCompiled == 0)
+	{
+		s_deleteShader(shaderID);
+		return 0;
+	}
+	return shaderID;
+}
+
+ChunkTileShader::ChunkTileShader()
+	: m_programID(0)
+	, m_quadIndexBufferID(0)
+	, m_tileInsetLocation(-1)
+	, m_outdoorLightLevelLocation(-1)
+{
+}
+
+ChunkTileShader::~ChunkTileShader()
+{
+	if (m_programID != 0)
+		s_deleteProgram(m_programID);
+	if (m_quadIndexBufferID != 0)
+		s_deleteBuffers(1, &m_quadIndexBufferID);
+}
+
+bool ChunkTileShader::Create(const AABB2D& firstTileTexCoords, const AABB2D& diagonalTileTexCoords)
+{
+	if (!LoadGLFunctions())
+		return false;
+
+	GLuint vertexShaderID = CompileShader(SHADER_TYPE_VERTEX, CHUNK_TILE_VERTEX_SHADER);
+	GLuint fragmentShaderID = CompileShader(SHADER_TYPE_FRAGMENT, CHUNK_TILE_FRAGMENT_SHADER);
+	if (vertexShaderID == 0 || fragmentShaderID == 0)
+	{
+		if (vertexShaderID != 0)
+			s_deleteShader(vertexShaderID);
+		if (fragmentShaderID != 0)
+			s_deleteShader(fragmentShaderID);
+		return false;
+	}
+
+	GLuint programID = s_createProgram();
+	s_attachShader(programID, vertexShaderID);
+	s_attachShader(programID, fragmentShaderID);
+	s_bindAttribLocation(programID, PACKED_VERTEX_ATTRIBUTE, "a_packedVertex");
+	s_linkProgram(programID);
+	s_deleteShader(vertexShaderID);
+	s_deleteShader(fragmentShaderID);
+
+	GLint isLinked = 0;
+	s_getProgramiv(programID, PROGRAM_LINK_STATUS, &isLinked);
+	if (isLinked == 0)
+	{
+		s_deleteProgram(programID);
+		return false;
+	}
+	m_programID = programID;
+
+	//tiles are laid out on a grid, so tile (x, y) starts x and y steps from the first one whichever way the sprite sheet flips them
+	s_useProgram(m_programID);
+	s_uniform1i(s_getUniformLocation(m_programID, "u_atlas"), 0);
+	s_uniform2f(s_getUniformLocation(m_programID, "u_firstTileMins"), firstTileTexCoords.mins.x, firstTileTexCoords.mins.y);
+	s_uniform2f(s_getUniformLocation(m_programID, "u_tileStep"), diagonalTileTexCoords.mins.x - firstTileTexCoords.mins.x, diagonalTileTexCoords.mins.y - firstTileTexCoords.mins.y);
+	m_tileSize = Vector2(firstTileTexCoords.maxs.x - firstTileTexCoords.mins.x, firstTileTexCoords.maxs.y - firstTileTexCoords.mins.y);
+	s_uniform2f(s_getUniformLocation(m_programID, "u_tileSize"), m_tileSize.x, m_tileSize.y);
+	m_tileInsetLocation = s_getUniformLocation(m_programID, "u_tileInset");
+	m_outdoorLightLevelLocation = s_getUniformLocation(m_programID, "u_outdoorLightLevel");
+	s_useProgram(0);
+
+	//sections lay their quads out as four corners in order, so one index buffer sized for the fullest section serves them all
+	std::vector< unsigned short > quadIndexes;
+	quadIndexes.reserve(MAX_INDEXES_PER_SECTION);
+	for (int quadIndex = 0; quadIndex < MAX_QUADS_PER_SECTION; ++quadIndex)
+	{
+		unsigned short firstVertexIndex = (unsigned short) (quadIndex * NUM_VERTEXES_PER_QUAD);
+		quadIndexes.push_back(firstVertexIndex);
+		quadIndexes.push_back(firstVertexIndex + 1);
+		quadIndexes.push_back(firstVertexIndex + 2);
+		quadIndexes.push_back(firstVertexIndex);
+		quadIndexes.push_back(firstVertexIndex + 2);
+		quadIndexes.push_back(firstVertexIndex + 3);
+	}
+	s_genBuffers(1, &m_quadIndexBufferID);
+	s_bindBuffer(BUFFER_TARGET_ELEMENT_ARRAY, m_quadIndexBufferID);
+	s_bufferData(BUFFER_TARGET_ELEMENT_ARRAY, (GLsizeiptr) quadIndexes.size() * (GLsizeiptr) sizeof(unsigned short), &quadIndexes[0], BUFFER_USAGE_STATIC_DRAW);
+	s_bindBuffer(BUFFER_TARGET_ELEMENT_ARRAY, 0);
+	return true;
+}
+
+void ChunkTileShader::Bind(int outdoorLightLevel) const
+{
+	if (m_programID == 0)
+		return;
+
+	//the inset is half a texel of the bound atlas, in fractions of a tile
+	s_useProgram(m_programID);
+	GLint atlasWidth = 0;
+	GLint atlasHeight = 0;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &atlasWidth);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &atlasHeight);
+	if (atlasWidth > 0 && atlasHeight > 0)
+		s_uniform2f(m_tileInsetLocation, TILE_INSET_TEXELS / (fabsf(m_tileSize.x) * (float) atlasWidth), TILE_INSET_TEXELS / (fabsf(m_tileSize.y) * (float) atlasHeight));
+
+	//the day and night cycle only ever changes this uniform, the uploaded vertexes keep their light
+	s_uniform1f(m_outdoorLightLevelLocation, (float) outdoorLightLevel);
+	s_enableVertexAttribArray(PACKED_VERTEX_ATTRIBUTE);
+	s_bindBuffer(BUFFER_TARGET_ELEMENT_ARRAY, m_quadIndexBufferID);
+}
+
+void ChunkTileShader::Unbind() const
+{
+	if (m_programID == 0)
+		return;
+
+	s_disableVertexAttribArray(PACKED_VERTEX_ATTRIBUTE);
+	s_bindBuffer(BUFFER_TARGET_ELEMENT_ARRAY, 0);
+	s_bindBuffer(BUFFER_TARGET_ARRAY, 0);
+	s_useProgram(0);
+}
+
+bool ChunkTileShader::IsValid() const
+{
+	return m_programID != 0;
+}
+
+unsigned int ChunkTileShader::CreateVertexBuffer()
+{
+	ASSERT_OR_DIE(LoadGLFunctions(), "Chunk meshes need OpenGL 2.0 vertex buffers and shaders");
+	GLuint bufferID = 0;
+	s_genBuffers(1, &bufferID);
+	return bufferID;
+}
+
+void ChunkTileShader::DestroyVertexBuffer(unsigned int bufferID)
+{
+	s_deleteBuffers(1, &bufferID);
+}
+
+void ChunkTileShader::UpdateVertexBuffer(unsigned int bufferID, const ChunkVertex* vertexes, int numVertexes)
+{
+	s_bindBuffer(BUFFER_TARGET_ARRAY, bufferID);
+	s_bufferData(BUFFER_TARGET_ARRAY, (GLsizeiptr) numVertexes * (GLsizeiptr) sizeof(ChunkVertex), vertexes, BUFFER_USAGE_STATIC_DRAW);
+	s_bindBuffer(BUFFER_TARGET_ARRAY, 0);
+}
+
+void ChunkTileShader::DrawVertexBuffer(unsigned int bufferID, int numIndexes)
+{
+	//both words go up as they are and become floats, the vertex shader takes them apart
+	//the quad index buffer bound with the shader turns each run of four corners into two triangles
+	s_bindBuffer(BUFFER_TARGET_ARRAY, bufferID);
+	s_vertexAttribPointer(PACKED_VERTEX_ATTRIBUTE, 2, GL_UNSIGNED_INT, GL_FALSE, (GLsizei) sizeof(ChunkVertex), nullptr);
+	glDrawElements(GL_TRIANGLES, numIndexes, GL_UNSIGNED_SHORT, nullptr);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Engine/Math/AABB2D.hpp"
+#include "Engine/Math/Vector2.hpp"
+
+struct ChunkVertex;
+
+//draws chunk sections straight from their packed vertexes, the vertex shader decodes position, tile, corner and light
+//each atlas tile is repeated across the quad instead of stretched, so greedy quads look like single blocks
+//gl/gl.h stops at OpenGL 1.1, the shader and buffer entry points past it are looked up from the driver here
+class ChunkTileShader
+{
+public:
+	ChunkTileShader();
+	~ChunkTileShader();
+
+	bool Create(const AABB2D& firstTileTexCoords, const AABB2D& diagonalTileTexCoords);
+	void Bind(int outdoorLightLevel) const;
+	void Unbind() const;
+	bool IsValid() const;
+
+	static unsigned int CreateVertexBuffer();
+	static void DestroyVertexBuffer(unsigned int bufferID);
+	static void UpdateVertexBuffer(unsigned int bufferID, const ChunkVertex* vertexes, int numVertexes);
+	static void DrawVertexBuffer(unsigned int bufferID, int numIndexes); //only while bound
+
+private:
+	unsigned int m_programID;
+	unsigned int m_quadIndexBufferID; //the same two triangles per quad for every section
+	int m_tileInsetLocation;
+	int m_outdoorLightLevelLocation;
+	Vector2 m_tileSize; //of one tile in atlas coords, negative along a flipped axis
+};
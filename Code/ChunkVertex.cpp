@@ -0,0 +1,93 @@
+#include "Game/ChunkVertex.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Block.hpp"
+#include "Engine/Math/IntVector3.hpp"
+
+//the chunk tile shader decodes the same layout on the GPU, the two change together
+const int BITS_POSITION_X = 5;
+const int BITS_POSITION_Y = 5;
+const int BITS_POSITION_Z = 8;
+const int BITS_FACE = 3;
+const int SHIFT_POSITION_Y = BITS_POSITION_X;
+const int SHIFT_POSITION_Z = SHIFT_POSITION_Y + BITS_POSITION_Y;
+const int SHIFT_FACE = SHIFT_POSITION_Z + BITS_POSITION_Z;
+const int SHIFT_TEX_CORNER = SHIFT_FACE + BITS_FACE;
+const int SHIFT_LIGHT = 8;
+const int BITS_TILE_REPEATS = 4;
+const int SHIFT_TILE_REPEATS_U = 16;
+const int SHIFT_TILE_REPEATS_V = SHIFT_TILE_REPEATS_U + BITS_TILE_REPEATS;
+const unsigned int MASK_POSITION_X = (1 << BITS_POSITION_X) - 1;
+const unsigned int MASK_POSITION_Y = (1 << BITS_POSITION_Y) - 1;
+const unsigned int MASK_POSITION_Z = (1 << BITS_POSITION_Z) - 1;
+const unsigned int MASK_FACE = (1 << BITS_FACE) - 1;
+const unsigned int MASK_TEX_CORNER = 3;
+const unsigned int MASK_TILE = 0xff;
+const unsigned int MASK_TILE_REPEATS = (1 << BITS_TILE_REPEATS) - 1;
+
+ChunkVertex::ChunkVertex()
+	: m_positionAndFace(0)
+	, m_tileAndLight(0)
+{
+}
+
+ChunkVertex::ChunkVertex(const IntVector3& localPosition, BlockFace face, TexCorner texCorner, unsigned char tileIndex, int packedLight, const IntVector2& tileRepeats)
+{
+	m_positionAndFace = (unsigned int) localPosition.x
+		| ((unsigned int) localPosition.y << SHIFT_POSITION_Y)
+		| ((unsigned int) localPosition.z << SHIFT_POSITION_Z)
+		| ((unsigned int) face << SHIFT_FACE)
+		| ((unsigned int) texCorner << SHIFT_TEX_CORNER);
+	m_tileAndLight = (unsigned int) tileIndex 
+		| (((unsigned int) packedLight & MASK_PACKED_LIGHT) << SHIFT_LIGHT)
+		| (((unsigned int) (tileRepeats.x - 1) & MASK_TILE_REPEATS) << SHIFT_TILE_REPEATS_U)
+		| (((unsigned int) (tileRepeats.y - 1) & MASK_TILE_REPEATS) << SHIFT_TILE_REPEATS_V);
+}
+
+IntVector3 ChunkVertex::GetLocalPosition() const
+{
+	return IntVector3(	m_positionAndFace & MASK_POSITION_X, 
+						(m_positionAndFace >> SHIFT_POSITION_Y) & MASK_POSITION_Y, 
+						(m_positionAndFace >> SHIFT_POSITION_Z) & MASK_POSITION_Z );
+}
+
+BlockFace ChunkVertex::GetFace() const
+{
+	return (BlockFace) ((m_positionAndFace >> SHIFT_FACE) & MASK_FACE);
+}
+
+TexCorner ChunkVertex::GetTexCorner() const
+{
+	return (TexCorner) ((m_positionAndFace >> SHIFT_TEX_CORNER) & MASK_TEX_CORNER);
+}
+
+unsigned char ChunkVertex::GetTileIndex() const
+{
+	return (unsigned char) (m_tileAndLight & MASK_TILE);
+}
+
+int ChunkVertex::GetPackedLight() const
+{
+	return (m_tileAndLight >> SHIFT_LIGHT) & MASK_PACKED_LIGHT;
+}
+
+IntVector2 ChunkVertex::GetTileRepeats() const
+{
+	return IntVector2(	(int) ((m_tileAndLight >> SHIFT_TILE_REPEATS_U) & MASK_TILE_REPEATS) + 1,
+						(int) ((m_tileAndLight >> SHIFT_TILE_REPEATS_V) & MASK_TILE_REPEATS) + 1 );
+}
+
+void ChunkVertex::SetPackedLight(int packedLight)
+{
+	m_tileAndLight &= ~((unsigned int) MASK_PACKED_LIGHT << SHIFT_LIGHT);
+	m_tileAndLight |= ((unsigned int) packedLight & MASK_PACKED_LIGHT) << SHIFT_LIGHT;
+}
+
+int ChunkVertex::CalcNumIndexesForVertexes(int numVertexes)
+{
+	return (numVertexes / NUM_VERTEXES_PER_QUAD) * NUM_INDEXES_PER_QUAD;
+}
+
+unsigned char ChunkVertex::GetTileIndexForSpriteCoords(int spriteX, int spriteY)
+{
+	return (unsigned char) (spriteX + (spriteY * ATLAS_TILES_WIDE));
+}
\ No newline at end of file
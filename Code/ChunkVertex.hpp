@@ -0,0 +1,46 @@
+#pragma once
+#include "Game/BlockDefinition.hpp"
+#include "Game/GameCommon.hpp"
+#include "Engine/Math/IntVector2.hpp"
+#include <vector>
+
+class IntVector3;
+
+const int ATLAS_TILES_WIDE = 16;
+const int ATLAS_TILES_TALL = 16;
+const int ATLAS_NUM_TILES = ATLAS_TILES_WIDE * ATLAS_TILES_TALL;
+const int MAX_TILE_REPEATS = 16; //a greedy quad spans at most a section side
+const int NUM_VERTEXES_PER_QUAD = 4;
+const int NUM_INDEXES_PER_QUAD = 6;
+const int MAX_QUADS_PER_SECTION = (NUM_BLOCKS_PER_SECTION / 2) * BLOCK_FACE_SIZE; //checkerboard, every face of every other block
+const int MAX_INDEXES_PER_SECTION = MAX_QUADS_PER_SECTION * NUM_INDEXES_PER_QUAD; //its corners still fit 16 bit indexes
+
+enum TexCorner
+{
+	TEX_CORNER_MINS,
+	TEX_CORNER_MAXS_X_MINS_Y,
+	TEX_CORNER_MAXS,
+	TEX_CORNER_MINS_X_MAXS_Y
+};
+
+//8 bytes instead of the 24 of a Vertex3_PCT, uploaded as it is and decoded by the chunk tile shader
+//sections keep their copy to recolor light changes and fill the mesh cache
+struct ChunkVertex
+{
+	unsigned int m_positionAndFace;	//x: 5 bits, y: 5 bits, z: 8 bits, face: 3 bits, tex corner: 2 bits
+	unsigned int m_tileAndLight;	//atlas tile: 8 bits, block light: 4 bits, sky light: 4 bits, tile repeats - 1 along u and v: 4 bits each
+
+	ChunkVertex();
+	ChunkVertex(const IntVector3& localPosition, BlockFace face, TexCorner texCorner, unsigned char tileIndex, int packedLight, const IntVector2& tileRepeats);
+
+	IntVector3 GetLocalPosition() const;
+	BlockFace GetFace() const;
+	TexCorner GetTexCorner() const;
+	unsigned char GetTileIndex() const;
+	int GetPackedLight() const;
+	IntVector2 GetTileRepeats() const;
+	void SetPackedLight(int packedLight);
+
+	static int CalcNumIndexesForVertexes(int numVertexes); //two triangles per quad
+	static unsigned char GetTileIndexForSpriteCoords(int spriteX, int spriteY);
+};
\ No newline at end of file
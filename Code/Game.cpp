@@ -847,6 +847,57 @@ void Game::RenderText() const
 
 	std::string rainNoiseString = "Rain Noise: " + std::to_string(m_rainPerlinNoise);
 	g_theRenderer->DrawText2D(Vector2(5.f, 660.f), rainNoiseString, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string meshingText = "Meshing: ";
+	if (g_isGreedyMeshing)
+		meshingText += "GREEDY";
+	else
+		meshingText += "PER FACE";
+	meshingText += " (" + std::to_string(m_world->CalcNumChunkVertexes()) + " vertexes, " + std::to_string(m_world->CalcNumChunkIndexes()) + " indexes)";
+	g_theRenderer->DrawText2D(Vector2(5.f, 645.f), meshingText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string meshJobsText = "Mesh Jobs: " + std::to_string(m_world->m_numMeshJobsInFlight) + " in flight on " + std::to_string(m_world->m_meshWorkers->GetNumWorkers()) + " workers";
+	g_theRenderer->DrawText2D(Vector2(5.f, 630.f), meshJobsText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string meshBenchmarkText = "Mesh Benchmark: per block " + std::to_string(m_world->m_meshBenchmarkBlockMilliseconds) + "ms, bitmask " + std::to_string(m_world->m_meshBenchmarkMaskMilliseconds) + "ms per chunk";
+	g_theRenderer->DrawText2D(Vector2(5.f, 615.f), meshBenchmarkText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	//counts the buffers the game owns, the driver storage behind each VBO upload is not visible from here
+	std::string meshAllocationsText = "Mesh Allocations: " + std::to_string(m_world->m_meshArena.GetNumAllocations()) + " arena total, " + std::to_string(m_world->m_meshArena.GetNumAllocationsForLastRemesh()) + " last remesh, " + std::to_string(m_world->CalcNumMeshQueueGrowths()) + " job queue growths (VBO uploads not counted)";
+	g_theRenderer->DrawText2D(Vector2(5.f, 600.f), meshAllocationsText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string chunkLODText = "Chunk LODs: " + std::to_string(m_world->CalcNumChunksAtLOD(CHUNK_LOD_FULL)) + " full, " + std::to_string(m_world->CalcNumChunksAtLOD(CHUNK_LOD_2X)) + " 2x, " + std::to_string(m_world->CalcNumChunksAtLOD(CHUNK_LOD_4X)) + " 4x";
+	g_theRenderer->DrawText2D(Vector2(5.f, 585.f), chunkLODText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string remeshQueueText = "Remesh Queue: " + std::to_string(m_world->m_remeshScheduler.GetNumQueuedChunks()) + " chunks";
+	g_theRenderer->DrawText2D(Vector2(5.f, 570.f), remeshQueueText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string meshesPerChunkText = "Meshes Per Chunk: " + std::to_string(m_world->CalcMeshesPerChunk()) + " (" + std::to_string(m_world->m_numChunkMeshJobs) + " meshes for " + std::to_string(m_world->m_numChunksGenerated) + " chunks)";
+	g_theRenderer->DrawText2D(Vector2(5.f, 555.f), meshesPerChunkText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string lastEditText = "Last Edit: " + std::to_string(m_world->m_lastEditMilliseconds) + "ms to relight " + std::to_string(m_world->m_lastEditNumBlocksRelit) + " blocks and remesh";
+	g_theRenderer->DrawText2D(Vector2(5.f, 540.f), lastEditText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string meshCacheText = "Mesh Cache: " + std::to_string(m_world->m_meshCache.GetNumHits()) + " hits, " + std::to_string(m_world->m_meshCache.GetNumMisses()) + " misses";
+	g_theRenderer->DrawText2D(Vector2(5.f, 525.f), meshCacheText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string lightingText = "Lighting: " + std::to_string(m_world->m_dirtyLightingBlocks.GetSize()) + " queued, " + std::to_string(m_world->m_lightingBlocksPerMillisecond) + " blocks per ms";
+	g_theRenderer->DrawText2D(Vector2(5.f, 510.f), lightingText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string chunkPoolText = "Chunk Pool: " + std::to_string(m_world->m_chunkPool.GetNumChunksInUse()) + " in use, " + std::to_string(m_world->m_chunkPool.GetPeakNumChunksInUse()) + " peak of " + std::to_string(m_world->m_chunkPool.GetCapacity());
+	if (m_world->m_chunkPool.IsUsingLargePages())
+		chunkPoolText += " (large pages)";
+	g_theRenderer->DrawText2D(Vector2(5.f, 495.f), chunkPoolText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	//the VBOs and the copies kept to recolor and cache meshes both hold 8 byte packed vertexes
+	std::string meshMemoryText = "Mesh Memory: " + std::to_string(m_world->CalcNumChunkVBOBytes() / 1024) + " KB in VBOs + " + std::to_string(m_world->CalcNumChunkPackedVertexBytes() / 1024) + " KB copies for recolor and cache";
+	g_theRenderer->DrawText2D(Vector2(5.f, 480.f), meshMemoryText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string lightingCheckText = "Lighting Check: " + std::to_string(m_world->m_lightingCheckNumMismatches) + " mismatched blocks over " + std::to_string(m_world->m_lightingCheckNumEdits) + " edits and undo, relight " + std::to_string(m_world->m_lightingCheckRelightMilliseconds) + "ms, full recompute " + std::to_string(m_world->m_lightingCheckRecomputeMilliseconds) + "ms";
+	g_theRenderer->DrawText2D(Vector2(5.f, 465.f), lightingCheckText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
+
+	std::string solverCheckText = "Lighting Solver Check: " + std::to_string(m_world->m_solverCheckNumChunks) + " chunks, serial " + std::to_string(m_world->m_solverCheckSerialMilliseconds) + "ms, parallel " + std::to_string(m_world->m_solverCheckParallelMilliseconds) + "ms with " + std::to_string(m_world->m_solverCheckNumHelperJoins) + " helper joins, " + std::to_string(m_world->m_solverCheckNumEditMismatches) + " off edit relighting, " + std::to_string(m_world->m_solverCheckNumMismatches) + " parallel off serial";
+	g_theRenderer->DrawText2D(Vector2(5.f, 450.f), solverCheckText, 1.f, RGBA::WHITE, 10.f, bitmapFont);
 }
 
 void Game::RenderHUD() const
@@ -978,6 +1029,33 @@ void Game::KeyDown()
 		m_player.SetIsPhysicsWalking( !m_player.IsPhysicsWalking() );
 	}
 
+	if (g_theInput->WasKeyJustPressed(KEY_F7))
+	{
+		g_isGreedyMeshing = !g_isGreedyMeshing;
+		m_world->SetAllChunksDirty();
+	}
+
+	if (g_theInput->WasKeyJustPressed(KEY_F8))
+	{
+		m_world->RunMeshBenchmark();
+	}
+
+	if (g_theInput->WasKeyJustPressed(KEY_F9))
+	{
+		m_world->ResetStreamingCounters();
+	}
+
+	if (g_theInput->WasKeyJustPressed('L'))
+	{
+		m_world->RunLightingCheck();
+	}
+
+	if (g_theInput->WasKeyJustPressed('K'))
+	{
+		Vector3 playerPos = m_player.GetCenter();
+		m_world->RunLightingSolverCheck(playerPos);
+	}
+
 	if (g_theInput->WasKeyJustPressed('1'))
 	{
 		m_currentlySelectedBlockType = BLOCK_TYPE_STONE; 
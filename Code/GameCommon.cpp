@@ -10,4 +10,7 @@ float g_deltaSeconds = 0.f;
 bool g_isSavingAndLoading = false;
 bool g_loadAllChunksOnStartup = true;
 bool g_isWeatherActive = false;
-bool g_isHelpActive = false;
\ No newline at end of file
+bool g_isHelpActive = false;
+bool g_isGreedyMeshing = false;
+bool g_isMaskCulling = true;
+bool g_isMeshCaching = true;
\ No newline at end of file
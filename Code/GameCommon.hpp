@@ -18,14 +18,19 @@ const int CHUNK_BLOCKS_TALL_Z = 1 << CHUNK_BITS_Z;
 const int CHUNK_BLOCKS_PER_LAYER = 1 << CHUNK_BITS_XY;
 const int NUM_BLOCKS_PER_CHUNK = CHUNK_BLOCKS_WIDE_X * CHUNK_BLOCKS_DEEP_Y * CHUNK_BLOCKS_TALL_Z;
 const int TEST_NUM = 1 >> CHUNK_BLOCKS_WIDE_X;
+const int CHUNK_BITS_SECTION_Z = 4;
+const int CHUNK_SECTION_BLOCKS_TALL_Z = 1 << CHUNK_BITS_SECTION_Z;
+const int NUM_SECTIONS_PER_CHUNK = CHUNK_BLOCKS_TALL_Z / CHUNK_SECTION_BLOCKS_TALL_Z;
+const int NUM_BLOCKS_PER_SECTION = CHUNK_BLOCKS_PER_LAYER * CHUNK_SECTION_BLOCKS_TALL_Z;
 const int MASK_X = (1 << CHUNK_BITS_X) - 1; //15 - 0000000 0000 1111;
 const int MASK_Y = ( (1 << CHUNK_BITS_XY) - 1) & ~(MASK_X); //240 - 0000000 1111 0000;
 const int MASK_Z = ( (1 << CHUNK_BITS_XYZ) - 1) & ~(MASK_X | MASK_Y); //7936 - 0011111 0000 0000
-const unsigned char MASK_IS_SKY =			 0b10000000;
 const unsigned char MASK_IS_OPAQUE =		 0b01000000;
 const unsigned char MASK_IS_SOLID =			 0b00100000;
 const unsigned char MASK_IS_LIGHTING_DIRTY = 0b00010000;
 const unsigned char MASK_LIGHT =			 0b00001111;
+const int BITS_LIGHT = 4;
+const int MASK_PACKED_LIGHT = (1 << (BITS_LIGHT * 2)) - 1; //sky light in the high nibble, block light in the low
 
 extern Renderer* g_theRenderer;
 extern InputSystem* g_theInput;
@@ -36,3 +41,6 @@ extern bool g_isSavingAndLoading;
 extern bool g_loadAllChunksOnStartup;
 extern bool g_isWeatherActive;
 extern bool g_isHelpActive;
+extern bool g_isGreedyMeshing;
+extern bool g_isMaskCulling;
+extern bool g_isMeshCaching;
@@ -0,0 +1,21 @@
+#include "Game/LightingQueue.hpp"
+
+LightingQueue::LightingQueue()
+	: RingBuffer< unsigned int >(LIGHTING_QUEUE_INITIAL_CAPACITY)
+{
+}
+
+unsigned int LightingQueue::PackEntry(int chunkSlot, int blockIndex)
+{
+	return ((unsigned int) chunkSlot << CHUNK_BITS_XYZ) | (unsigned int) blockIndex;
+}
+
+int LightingQueue::GetChunkSlotForEntry(unsigned int entry)
+{
+	return (int) (entry >> CHUNK_BITS_XYZ);
+}
+
+int LightingQueue::GetBlockIndexForEntry(unsigned int entry)
+{
+	return (int) (entry & LIGHTING_ENTRY_BLOCK_INDEX_MASK);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include "Game/GameCommon.hpp"
+#include "Game/RingBuffer.hpp"
+
+const int LIGHTING_QUEUE_INITIAL_CAPACITY = 1 << 16;
+const int LIGHTING_ENTRY_BLOCK_INDEX_MASK = (1 << CHUNK_BITS_XYZ) - 1;
+
+//ring buffer of packed (chunk slot, block index) entries
+class LightingQueue : public RingBuffer< unsigned int >
+{
+public:
+	LightingQueue();
+
+	static unsigned int PackEntry(int chunkSlot, int blockIndex);
+	static int GetChunkSlotForEntry(unsigned int entry);
+	static int GetBlockIndexForEntry(unsigned int entry);
+};
@@ -0,0 +1,258 @@
+#include "Game/LightingSolver.hpp"
+#include "Engine/Math/IntVector3.hpp"
+
+LightingSolver::LightingSolver(WorkerThreadPool* workers)
+	: m_workers(workers)
+	, m_numJobs(0)
+	, m_blockDefinitions(nullptr)
+	, m_nextJobIndex(0)
+	, m_numHelpersQueued(0)
+	, m_numHelpersRunning(0)
+	, m_numHelperJoins(0)
+	, m_isRoundOpen(false)
+	, m_isSerial(false)
+{
+}
+
+LightingSolver::~LightingSolver()
+{
+	for (int jobIndex = 0; jobIndex < (int) m_jobs.size(); ++jobIndex)
+	{
+		delete m_jobs[jobIndex];
+	}
+}
+
+void LightingSolver::AddBlock(Chunk* chunk, int blockIndex)
+{
+	if (chunk->m_slotIndex >= (int) m_jobIndexForSlot.size())
+		m_jobIndexForSlot.resize(chunk->m_slotIndex + 1, -1);
+
+	//jobs are numbered in the order their chunks first show up in the world queue
+	int jobIndex = m_jobIndexForSlot[chunk->m_slotIndex];
+	if (jobIndex < 0)
+	{
+		if (m_numJobs == (int) m_jobs.size())
+			m_jobs.push_back(new ChunkLightingJob());
+
+		jobIndex = m_numJobs;
+		++m_numJobs;
+		m_jobIndexForSlot[chunk->m_slotIndex] = jobIndex;
+		ChunkLightingJob& job = *m_jobs[jobIndex];
+		job.m_chunk = chunk;
+		job.m_blockIndexes.clear();
+		job.m_numBlocksSolved = 0;
+		for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+		{
+			job.m_changedBorderBlockIndexes[borderIndex].clear();
+		}
+		job.m_hasLightChanged = false;
+	}
+	m_jobs[jobIndex]->m_blockIndexes.push_back((unsigned short) blockIndex);
+}
+
+void LightingSolver::SolveJobs(BlockDefinition* blockDefinitions[])
+{
+	if (m_numJobs == 0)
+		return;
+
+	m_blockDefinitions = blockDefinitions;
+	for (int jobIndex = 0; jobIndex < m_numJobs; ++jobIndex)
+	{
+		CopyNeighborBorders(*m_jobs[jobIndex]);
+	}
+
+	//the main thread solves jobs too, helpers jump the mesh jobs in the pool but are never waited on until they join
+	m_nextJobIndex = 0;
+	int numHelpersToQueue = 0;
+	{
+		std::lock_guard< std::mutex > lock(m_helpersMutex);
+		m_isRoundOpen = true;
+		int numHelpers = m_isSerial ? 0 : m_workers->GetNumWorkers();
+		if (numHelpers > m_numJobs - 1)
+			numHelpers = m_numJobs - 1;
+		if (numHelpers > m_numHelpersQueued)
+			numHelpersToQueue = numHelpers - m_numHelpersQueued;
+		m_numHelpersQueued += numHelpersToQueue;
+	}
+	for (int helperIndex = 0; helperIndex < numHelpersToQueue; ++helperIndex)
+	{
+		m_workers->AddUrgentJob(&LightingSolver::RunHelper, this, nullptr, nullptr);
+	}
+
+	SolveQueuedJobs();
+
+	//every job is claimed once the main thread runs dry, so only helpers still solving one are waited for
+	std::unique_lock< std::mutex > lock(m_helpersMutex);
+	m_isRoundOpen = false;
+	m_helpersFinished.wait(lock, [this]() { return m_numHelpersRunning == 0; });
+}
+
+void LightingSolver::RunHelper(void* jobOwner, void*, void*)
+{
+	//a helper that starts after its round closed, or with nothing left to claim, leaves without touching the jobs
+	LightingSolver* solver = (LightingSolver*) jobOwner;
+	{
+		std::lock_guard< std::mutex > lock(solver->m_helpersMutex);
+		--solver->m_numHelpersQueued;
+		if (!solver->m_isRoundOpen || solver->m_nextJobIndex >= solver->m_numJobs)
+			return;
+		++solver->m_numHelpersRunning;
+		++solver->m_numHelperJoins;
+	}
+
+	solver->SolveQueuedJobs();
+
+	std::lock_guard< std::mutex > lock(solver->m_helpersMutex);
+	--solver->m_numHelpersRunning;
+	if (solver->m_numHelpersRunning == 0)
+		solver->m_helpersFinished.notify_all();
+}
+
+void LightingSolver::ClearJobs()
+{
+	for (int jobIndex = 0; jobIndex < m_numJobs; ++jobIndex)
+	{
+		m_jobIndexForSlot[m_jobs[jobIndex]->m_chunk->m_slotIndex] = -1;
+	}
+	m_numJobs = 0;
+}
+
+int LightingSolver::GetNumJobs() const
+{
+	return m_numJobs;
+}
+
+ChunkLightingJob& LightingSolver::GetJob(int jobIndex)
+{
+	return *m_jobs[jobIndex];
+}
+
+void LightingSolver::SetIsSerial(bool isSerial)
+{
+	m_isSerial = isSerial;
+}
+
+int LightingSolver::GetNumHelperJoins() const
+{
+	std::lock_guard< std::mutex > lock(m_helpersMutex);
+	return m_numHelperJoins;
+}
+
+void LightingSolver::CopyNeighborBorders(ChunkLightingJob& job) const
+{
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		const Chunk* neighbor = job.m_chunk->GetNeighbor((LightingBorder) borderIndex);
+		job.m_hasNeighbor[borderIndex] = neighbor != nullptr;
+		if (neighbor == nullptr)
+			continue;
+
+		//the east border reads the west face of the east neighbor and so on
+		LightingBorder neighborBorder = Chunk::GetOppositeBorder((LightingBorder) borderIndex);
+		for (int neighborBorderIndex = 0; neighborBorderIndex < LIGHTING_BORDER_SIZE; ++neighborBorderIndex)
+		{
+			const Block& neighborBlock = neighbor->m_blocks[Chunk::GetBlockIndexForBorderIndex(neighborBorder, neighborBorderIndex)];
+			job.m_neighborBorderLight[borderIndex][neighborBorderIndex] = (unsigned char) neighborBlock.GetPackedLight();
+		}
+	}
+}
+
+void LightingSolver::SolveQueuedJobs()
+{
+	while (true)
+	{
+		int jobIndex = m_nextJobIndex++;
+		if (jobIndex >= m_numJobs)
+			return;
+		SolveJob(*m_jobs[jobIndex]);
+	}
+}
+
+void LightingSolver::SolveJob(ChunkLightingJob& job) const
+{
+	//same pull as edits through Block::CalcPulledPackedLight, neighbors across a border come from the copies taken before the round
+	Chunk* chunk = job.m_chunk;
+	while (job.m_numBlocksSolved < (int) job.m_blockIndexes.size() && job.m_numBlocksSolved < LIGHTING_BLOCKS_PER_JOB)
+	{
+		int blockIndex = job.m_blockIndexes[job.m_numBlocksSolved];
+		++job.m_numBlocksSolved;
+		Block& block = chunk->m_blocks[blockIndex];
+		if (!block.GetIsLightingDirty())
+			continue;
+		block.SetIsLightingDirty(false);
+		--chunk->m_numDirtyLightingBlocks;
+
+		IntVector3 blockCoords = Chunk::GetBlockCoordsForBlockIndex(blockIndex);
+		int neighborPackedLights[BLOCK_FACE_SIZE];
+		int numNeighbors = 0;
+		if (blockCoords.z < CHUNK_BLOCKS_TALL_Z - 1)
+			neighborPackedLights[numNeighbors++] = chunk->m_blocks[blockIndex + CHUNK_BLOCKS_PER_LAYER].GetPackedLight();
+		if (blockCoords.z > 0)
+			neighborPackedLights[numNeighbors++] = chunk->m_blocks[blockIndex - CHUNK_BLOCKS_PER_LAYER].GetPackedLight();
+		if (blockCoords.x < CHUNK_BLOCKS_WIDE_X - 1)
+			neighborPackedLights[numNeighbors++] = chunk->m_blocks[blockIndex + 1].GetPackedLight();
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_EAST])
+			neighborPackedLights[numNeighbors++] = job.m_neighborBorderLight[LIGHTING_BORDER_EAST][GetBorderIndexForBlockCoords(LIGHTING_BORDER_EAST, blockCoords)];
+		if (blockCoords.x > 0)
+			neighborPackedLights[numNeighbors++] = chunk->m_blocks[blockIndex - 1].GetPackedLight();
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_WEST])
+			neighborPackedLights[numNeighbors++] = job.m_neighborBorderLight[LIGHTING_BORDER_WEST][GetBorderIndexForBlockCoords(LIGHTING_BORDER_WEST, blockCoords)];
+		if (blockCoords.y < CHUNK_BLOCKS_DEEP_Y - 1)
+			neighborPackedLights[numNeighbors++] = chunk->m_blocks[blockIndex + CHUNK_BLOCKS_WIDE_X].GetPackedLight();
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_NORTH])
+			neighborPackedLights[numNeighbors++] = job.m_neighborBorderLight[LIGHTING_BORDER_NORTH][GetBorderIndexForBlockCoords(LIGHTING_BORDER_NORTH, blockCoords)];
+		if (blockCoords.y > 0)
+			neighborPackedLights[numNeighbors++] = chunk->m_blocks[blockIndex - CHUNK_BLOCKS_WIDE_X].GetPackedLight();
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_SOUTH])
+			neighborPackedLights[numNeighbors++] = job.m_neighborBorderLight[LIGHTING_BORDER_SOUTH][GetBorderIndexForBlockCoords(LIGHTING_BORDER_SOUTH, blockCoords)];
+
+		int originalPackedLight = block.GetPackedLight();
+		int selfIllumination = m_blockDefinitions[block.GetBlockType()]->GetSelfIllumination();
+		block.SetPackedLight(Block::CalcPulledPackedLight(block.GetIsOpaque(), chunk->IsBlockSky(blockIndex), selfIllumination, neighborPackedLights, numNeighbors));
+		if (originalPackedLight == block.GetPackedLight())
+			continue;
+
+		//neighbors in this chunk are queued right away, the ones across a border are handed to the world
+		job.m_hasLightChanged = true;
+		chunk->SetBlockLightIsDirty(blockIndex);
+		if (blockCoords.z < CHUNK_BLOCKS_TALL_Z - 1)
+			AddJobBlock(job, blockIndex + CHUNK_BLOCKS_PER_LAYER);
+		if (blockCoords.z > 0)
+			AddJobBlock(job, blockIndex - CHUNK_BLOCKS_PER_LAYER);
+		if (blockCoords.x < CHUNK_BLOCKS_WIDE_X - 1)
+			AddJobBlock(job, blockIndex + 1);
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_EAST])
+			job.m_changedBorderBlockIndexes[LIGHTING_BORDER_EAST].push_back((unsigned short) blockIndex);
+		if (blockCoords.x > 0)
+			AddJobBlock(job, blockIndex - 1);
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_WEST])
+			job.m_changedBorderBlockIndexes[LIGHTING_BORDER_WEST].push_back((unsigned short) blockIndex);
+		if (blockCoords.y < CHUNK_BLOCKS_DEEP_Y - 1)
+			AddJobBlock(job, blockIndex + CHUNK_BLOCKS_WIDE_X);
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_NORTH])
+			job.m_changedBorderBlockIndexes[LIGHTING_BORDER_NORTH].push_back((unsigned short) blockIndex);
+		if (blockCoords.y > 0)
+			AddJobBlock(job, blockIndex - CHUNK_BLOCKS_WIDE_X);
+		else if (job.m_hasNeighbor[LIGHTING_BORDER_SOUTH])
+			job.m_changedBorderBlockIndexes[LIGHTING_BORDER_SOUTH].push_back((unsigned short) blockIndex);
+	}
+}
+
+void LightingSolver::AddJobBlock(ChunkLightingJob& job, int blockIndex) const
+{
+	//same queued flag and count as the world queue, the block belongs to this job's chunk
+	Block& block = job.m_chunk->m_blocks[blockIndex];
+	if (block.GetIsLightingDirty())
+		return;
+	block.SetIsLightingDirty(true);
+	++job.m_chunk->m_numDirtyLightingBlocks;
+	job.m_blockIndexes.push_back((unsigned short) blockIndex);
+}
+
+int LightingSolver::GetBorderIndexForBlockCoords(LightingBorder border, const IntVector3& blockCoords)
+{
+	//east and west borders run along y, north and south along x
+	if (border == LIGHTING_BORDER_EAST || border == LIGHTING_BORDER_WEST)
+		return blockCoords.y + (blockCoords.z * CHUNK_BLOCKS_DEEP_Y);
+	return blockCoords.x + (blockCoords.z * CHUNK_BLOCKS_WIDE_X);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Game/Chunk.hpp"
+#include "Game/WorkerThreadPool.hpp"
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+const int LIGHTING_BLOCKS_PER_JOB = NUM_BLOCKS_PER_CHUNK * 2; //per chunk per round, the rest waits for the next round
+
+//the lighting of one chunk for one round, only its own blocks are written while it is solved
+struct ChunkLightingJob
+{
+	Chunk* m_chunk;
+	std::vector< unsigned short > m_blockIndexes; //queued blocks, appended to while solving
+	int m_numBlocksSolved; //blocks past this index are handed back to the world queue
+	std::vector< unsigned short > m_changedBorderBlockIndexes[NUM_LIGHTING_BORDERS]; //their neighbor across the border is relit next round
+	unsigned char m_neighborBorderLight[NUM_LIGHTING_BORDERS][LIGHTING_BORDER_SIZE]; //packed light of the neighbor blocks touching each border
+	bool m_hasNeighbor[NUM_LIGHTING_BORDERS];
+	bool m_hasLightChanged;
+};
+
+//solves the queued lighting of every chunk in parallel, one job per chunk
+//each round reads its neighbors from border copies taken before it starts, so the result does not depend on thread timing
+class LightingSolver
+{
+public:
+	LightingSolver(WorkerThreadPool* workers);
+	~LightingSolver();
+
+	void AddBlock(Chunk* chunk, int blockIndex);
+	void SolveJobs(BlockDefinition* blockDefinitions[]);
+	void ClearJobs();
+	int GetNumJobs() const;
+	ChunkLightingJob& GetJob(int jobIndex);
+	void SetIsSerial(bool isSerial);
+	int GetNumHelperJoins() const;
+
+private:
+	void CopyNeighborBorders(ChunkLightingJob& job) const;
+	void SolveQueuedJobs();
+	void SolveJob(ChunkLightingJob& job) const;
+	void AddJobBlock(ChunkLightingJob& job, int blockIndex) const;
+
+	static void RunHelper(void* jobOwner, void* jobInput, void* jobOutput);
+	static int GetBorderIndexForBlockCoords(LightingBorder border, const IntVector3& blockCoords);
+
+	WorkerThreadPool* m_workers;
+	std::vector< ChunkLightingJob* > m_jobs; //kept between rounds so their buffers are reused
+	std::vector< int > m_jobIndexForSlot; //-1 when the chunk in that slot has no job this round
+	int m_numJobs;
+	BlockDefinition** m_blockDefinitions;
+	std::atomic< int > m_nextJobIndex;
+	int m_numHelpersQueued; //helper jobs in the pool that have not started, they may outlive the round they were queued for
+	int m_numHelpersRunning; //only helpers that joined an open round
+	int m_numHelperJoins; //helpers that found work, since the solver was made
+	bool m_isRoundOpen;
+	bool m_isSerial; //the main thread solves every job alone, used to check the parallel result
+	mutable std::mutex m_helpersMutex;
+	std::condition_variable m_helpersFinished;
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include <vector>
+
+//queue over one power of two buffer, grows by doubling and never shrinks, so a warm queue never touches the heap
+template< typename T >
+class RingBuffer
+{
+public:
+	explicit RingBuffer(int initialCapacity);
+
+	void PushBack(const T& item);
+	void PushFront(const T& item);
+	T PopFront();
+	void Clear();
+	bool IsEmpty() const;
+	int GetSize() const;
+	int GetCapacity() const;
+	int GetNumGrowths() const;
+
+private:
+	void Grow();
+
+	std::vector< T > m_items;
+	int m_headIndex;
+	int m_size;
+	int m_numGrowths;
+};
+
+template< typename T >
+RingBuffer< T >::RingBuffer(int initialCapacity)
+	: m_items(initialCapacity)
+	, m_headIndex(0)
+	, m_size(0)
+	, m_numGrowths(0)
+{
+}
+
+template< typename T >
+void RingBuffer< T >::PushBack(const T& item)
+{
+	if (m_size == (int) m_items.size())
+		Grow();
+
+	int tailIndex = (m_headIndex + m_size) & ((int) m_items.size() - 1);
+	m_items[tailIndex] = item;
+	++m_size;
+}
+
+template< typename T >
+void RingBuffer< T >::PushFront(const T& item)
+{
+	if (m_size == (int) m_items.size())
+		Grow();
+
+	m_headIndex = (m_headIndex - 1) & ((int) m_items.size() - 1);
+	m_items[m_headIndex] = item;
+	++m_size;
+}
+
+template< typename T >
+T RingBuffer< T >::PopFront()
+{
+	T item = m_items[m_headIndex];
+	m_headIndex = (m_headIndex + 1) & ((int) m_items.size() - 1);
+	--m_size;
+	return item;
+}
+
+template< typename T >
+void RingBuffer< T >::Clear()
+{
+	m_headIndex = 0;
+	m_size = 0;
+}
+
+template< typename T >
+bool RingBuffer< T >::IsEmpty() const
+{
+	return m_size == 0;
+}
+
+template< typename T >
+int RingBuffer< T >::GetSize() const
+{
+	return m_size;
+}
+
+template< typename T >
+int RingBuffer< T >::GetCapacity() const
+{
+	return (int) m_items.size();
+}
+
+template< typename T >
+int RingBuffer< T >::GetNumGrowths() const
+{
+	return m_numGrowths;
+}
+
+template< typename T >
+void RingBuffer< T >::Grow()
+{
+	//items are unwrapped into the front of the larger buffer
+	int capacity = (int) m_items.size();
+	std::vector< T > items(capacity * 2);
+	for (int itemIndex = 0; itemIndex < m_size; ++itemIndex)
+	{
+		items[itemIndex] = m_items[(m_headIndex + itemIndex) & (capacity - 1)];
+	}
+	m_items.swap(items);
+	m_headIndex = 0;
+	++m_numGrowths;
+}
@@ -0,0 +1,115 @@
+#include "Game/WorkerThreadPool.hpp"
+
+WorkerThreadPool::WorkerThreadPool(int numWorkers)
+	: m_jobs(WORKER_JOBS_INITIAL_CAPACITY)
+	, m_numUnfinishedJobs(0)
+	, m_isQuitting(false)
+{
+	if (numWorkers < 1)
+		numWorkers = 1;
+
+	for (int workerIndex = 0; workerIndex < numWorkers; ++workerIndex)
+	{
+		m_workers.push_back( std::thread(&WorkerThreadPool::RunWorker, this) );
+	}
+}
+
+WorkerThreadPool::~WorkerThreadPool()
+{
+	{
+		std::lock_guard< std::mutex > lock(m_jobsMutex);
+		m_isQuitting = true;
+		m_jobs.Clear();
+	}
+	m_jobAvailable.notify_all();
+
+	for (int workerIndex = 0; workerIndex < (int) m_workers.size(); ++workerIndex)
+	{
+		m_workers[workerIndex].join();
+	}
+}
+
+void WorkerThreadPool::AddJob(WorkerJobFunction function, void* owner, void* input, void* output)
+{
+	QueueJob(function, owner, input, output, false);
+}
+
+void WorkerThreadPool::AddUrgentJob(WorkerJobFunction function, void* owner, void* input, void* output)
+{
+	QueueJob(function, owner, input, output, true);
+}
+
+void WorkerThreadPool::WaitForAllJobs()
+{
+	std::unique_lock< std::mutex > lock(m_jobsMutex);
+	m_allJobsFinished.wait(lock, [this]() { return m_numUnfinishedJobs == 0; });
+}
+
+int WorkerThreadPool::GetNumWorkers() const
+{
+	return (int) m_workers.size();
+}
+
+int WorkerThreadPool::GetNumUnfinishedJobs()
+{
+	std::lock_guard< std::mutex > lock(m_jobsMutex);
+	return m_numUnfinishedJobs;
+}
+
+int WorkerThreadPool::GetNumJobQueueGrowths()
+{
+	std::lock_guard< std::mutex > lock(m_jobsMutex);
+	return m_jobs.GetNumGrowths();
+}
+
+int WorkerThreadPool::CalcDefaultNumWorkers()
+{
+	//leave a core for the main thread
+	int numCores = (int) std::thread::hardware_concurrency();
+	if (numCores <= 1)
+		return 1;
+	return numCores - 1;
+}
+
+void WorkerThreadPool::QueueJob(WorkerJobFunction function, void* owner, void* input, void* output, bool isUrgent)
+{
+	WorkerJob job;
+	job.m_function = function;
+	job.m_owner = owner;
+	job.m_input = input;
+	job.m_output = output;
+	{
+		std::lock_guard< std::mutex > lock(m_jobsMutex);
+		if (isUrgent)
+			m_jobs.PushFront(job);
+		else
+			m_jobs.PushBack(job);
+		++m_numUnfinishedJobs;
+	}
+	m_jobAvailable.notify_one();
+}
+
+void WorkerThreadPool::RunWorker()
+{
+	while (true)
+	{
+		WorkerJob job;
+		{
+			std::unique_lock< std::mutex > lock(m_jobsMutex);
+			m_jobAvailable.wait(lock, [this]() { return m_isQuitting || !m_jobs.IsEmpty(); });
+			if (m_isQuitting)
+				return;
+
+			job = m_jobs.PopFront();
+		}
+
+		job.m_function(job.m_owner, job.m_input, job.m_output);
+
+		{
+			std::lock_guard< std::mutex > lock(m_jobsMutex);
+			--m_numUnfinishedJobs;
+			if (m_numUnfinishedJobs == 0)
+				m_allJobsFinished.notify_all();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include "Game/RingBuffer.hpp"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+const int WORKER_JOBS_INITIAL_CAPACITY = 256;
+
+typedef void (*WorkerJobFunction)(void* jobOwner, void* jobInput, void* jobOutput);
+
+//plain record instead of a captured closure, queueing one copies it into the ring without touching the heap
+struct WorkerJob
+{
+	WorkerJobFunction m_function;
+	void* m_owner;
+	void* m_input;
+	void* m_output;
+};
+
+class WorkerThreadPool
+{
+public:
+	WorkerThreadPool(int numWorkers);
+	~WorkerThreadPool();
+
+	void AddJob(WorkerJobFunction function, void* owner, void* input, void* output);
+	void AddUrgentJob(WorkerJobFunction function, void* owner, void* input, void* output); //runs before every job already queued
+	void WaitForAllJobs();
+	int GetNumWorkers() const;
+	int GetNumUnfinishedJobs();
+	int GetNumJobQueueGrowths();
+
+	static int CalcDefaultNumWorkers();
+
+private:
+	std::vector< std::thread > m_workers;
+	RingBuffer< WorkerJob > m_jobs;
+	std::mutex m_jobsMutex;
+	std::condition_variable m_jobAvailable;
+	std::condition_variable m_allJobsFinished;
+	int m_numUnfinishedJobs;
+	bool m_isQuitting;
+
+	void QueueJob(WorkerJobFunction function, void* owner, void* input, void* output, bool isUrgent);
+	void RunWorker();
+};
\ No newline at end of file
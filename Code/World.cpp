@@ -1,21 +1,52 @@
 #include "Game/World.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/ChunkVertex.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+
+static bool IsFartherDeactivationCandidate(const ChunkDeactivationCandidate& first, const ChunkDeactivationCandidate& second)
+{
+	return first.m_distance > second.m_distance;
+}
 
 World::World()
 	: m_maxNumChunks(10000)
 	, m_minNumChunks(500) //runs out of memory when greater than 402
 	, m_minRangeOfActiveChunks(100)
-	, m_distanceToIterToManipulate(0.f)
-	, m_distanceToPlayer(1000.f)
 	, m_timeOfDay(550.f) //out of 1000
-	, m_fileVersionNumber(1)
+	, m_fileVersionNumber(2)
 	, m_dayMaxLightLevel(15)
 	, m_nightMinLightLevel(6)
+	, m_nextMeshJobID(0)
+	, m_numMeshJobsInFlight(0)
+	, m_numChunksGenerated(0)
+	, m_numChunkMeshJobs(0)
+	, m_isRelightingEdit(false)
+	, m_lastEditNumBlocksRelit(0)
+	, m_lastEditMilliseconds(0.f)
+	, m_lightingBlocksPerMillisecond(0.f)
+	, m_meshBenchmarkBlockMilliseconds(0.f)
+	, m_meshBenchmarkMaskMilliseconds(0.f)
+	, m_lightingCheckNumEdits(0)
+	, m_lightingCheckNumMismatches(0)
+	, m_lightingCheckRelightMilliseconds(0.f)
+	, m_lightingCheckRecomputeMilliseconds(0.f)
+	, m_solverCheckNumChunks(0)
+	, m_solverCheckNumMismatches(0)
+	, m_solverCheckNumEditMismatches(0)
+	, m_solverCheckNumHelperJoins(0)
+	, m_solverCheckSerialMilliseconds(0.f)
+	, m_solverCheckParallelMilliseconds(0.f)
+	, m_remeshScheduler(REMESH_SECONDS_PER_FRAME)
+	, m_chunkPool(CHUNK_POOL_CAPACITY, CHUNK_POOL_USES_LARGE_PAGES)
+	, m_completedMeshes(COMPLETED_MESHES_INITIAL_CAPACITY)
 {
+	m_meshWorkers = new WorkerThreadPool(WorkerThreadPool::CalcDefaultNumWorkers());
+	m_lightingSolver = new LightingSolver(m_meshWorkers);
 
 	m_outdoorLightLevel = (unsigned char) Clamp( (sin( (m_timeOfDay * DAY_LENGTH_DIVISOR) * fPI ) * (m_dayMaxLightLevel - m_nightMinLightLevel) ) + m_nightMinLightLevel, m_nightMinLightLevel, m_dayMaxLightLevel);
 	InitBlockDefs();
@@ -53,24 +84,32 @@ World::World()
 			UpdateChunks( playerPos, Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 0.f));
 		}
 
-		m_farthestEastChunk->m_blocks[NUM_BLOCKS_PER_CHUNK - 1].SetIsLightingDirty(true);
-		m_dirtyLightingBlocks.push_back(new BlockInfo(m_farthestEastChunk, NUM_BLOCKS_PER_CHUNK - 1));
-
 		for ( int chunkCount = 0; chunkCount <= m_minNumChunks; ++chunkCount )
 		{
 			UpdateLighting();
-			UpdateVertexArrays();
+			UpdateVertexArrays(playerPos);
 		}
 
 		for (int chunkCount = 0; chunkCount <= m_minNumChunks; ++chunkCount)
 		{
-			UpdateVertexArrays();
+			UpdateVertexArrays(playerPos);
 		}
 	}
 }
 
 World::~World()
 {
+	//the pool goes first, helper jobs left over from earlier lighting rounds still point at the solver
+	delete m_meshWorkers;
+	m_meshWorkers = nullptr;
+	delete m_lightingSolver;
+	m_lightingSolver = nullptr;
+
+	while (!m_completedMeshes.IsEmpty())
+	{
+		m_meshArena.ReleaseMeshResult(m_completedMeshes.PopFront());
+	}
+
 // 	for (int blockDefIndex = BLOCK_TYPE_SIZE; blockDefIndex > 0; --blockDefIndex)
 // 	{
 // 		delete m_blockDefinitions[blockDefIndex];
@@ -80,11 +119,6 @@ World::~World()
 // 	delete m_tileSheet;
 // 	m_tileSheet = nullptr;
 // 
-// 	for (int dirtyLightsCount = 0; dirtyLightsCount < (int) m_dirtyLightingBlocks.size(); ++dirtyLightsCount)
-// 	{
-// 		delete m_dirtyLightingBlocks[dirtyLightsCount];
-// 		m_dirtyLightingBlocks[dirtyLightsCount] = nullptr;
-// 	}
 
 // 	ChunkIterator chunkMapIter;
 // 	for (chunkMapIter = m_activeChunks.end(); chunkMapIter != m_activeChunks.begin(); --chunkMapIter)
@@ -126,13 +160,38 @@ void World::InitBlockDefs()
 	m_blockDefinitions[7] = new BlockDefinition(glowstone, BLOCK_TYPE_GLOWSTONE, true, true, 12);
 	m_blockDefinitions[8] = new BlockDefinition(snowSides, snowTop, dirtTile, BLOCK_TYPE_DIRTSNOW, true, true, 0);
 	m_blockDefinitions[9] = new BlockDefinition(snowTop, BLOCK_TYPE_SNOW, true, true, 0);
+
+	unsigned char airTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(0, 0);
+	unsigned char grassSidesTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(8, 8);
+	unsigned char grassTopTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(9, 8);
+	unsigned char dirtTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(7, 8);
+	unsigned char stoneTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(2, 10);
+	unsigned char waterTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(15, 11);
+	unsigned char cobblestoneTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(3, 10);
+	unsigned char sandTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(1, 8);
+	unsigned char glowstoneTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(4, 11);
+	unsigned char snowSidesTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(8, 7);
+	unsigned char snowTopTileIndex = ChunkVertex::GetTileIndexForSpriteCoords(0, 8);
+
+	m_blockDefinitions[0]->SetTileIndexes(airTileIndex, airTileIndex, airTileIndex);
+	m_blockDefinitions[1]->SetTileIndexes(grassSidesTileIndex, grassTopTileIndex, dirtTileIndex);
+	m_blockDefinitions[2]->SetTileIndexes(dirtTileIndex, dirtTileIndex, dirtTileIndex);
+	m_blockDefinitions[3]->SetTileIndexes(stoneTileIndex, stoneTileIndex, stoneTileIndex);
+	m_blockDefinitions[4]->SetTileIndexes(waterTileIndex, waterTileIndex, waterTileIndex);
+	m_blockDefinitions[5]->SetTileIndexes(cobblestoneTileIndex, cobblestoneTileIndex, cobblestoneTileIndex);
+	m_blockDefinitions[6]->SetTileIndexes(sandTileIndex, sandTileIndex, sandTileIndex);
+	m_blockDefinitions[7]->SetTileIndexes(glowstoneTileIndex, glowstoneTileIndex, glowstoneTileIndex);
+	m_blockDefinitions[8]->SetTileIndexes(snowSidesTileIndex, snowTopTileIndex, dirtTileIndex);
+	m_blockDefinitions[9]->SetTileIndexes(snowTopTileIndex, snowTopTileIndex, snowTopTileIndex);
+	bool isTileShaderCreated = m_tileShader.Create(m_tileSheet->GetTexCoordsForSpriteCoords(0, 0), m_tileSheet->GetTexCoordsForSpriteCoords(1, 1));
+	ASSERT_OR_DIE(isTileShaderCreated, "Chunks are drawn from packed vertexes and need the GLSL chunk tile shader");
 }
 
 void World::InitChunks()
 {
 	IntVector2 worldPos(0, 0);
 	if (!LoadChunkFromFile(worldPos))
-		m_activeChunks[worldPos] = new Chunk(worldPos, m_blockDefinitions);
+		ActivateChunk(worldPos);
 }
 
 void World::Update(float deltaSeconds, Vector3& playerPos, const Vector3& cameraForwardXYZ, const Vector3& cameraPos)
@@ -140,315 +199,789 @@ void World::Update(float deltaSeconds, Vector3& playerPos, const Vector3& camera
  	UpdateChunks(playerPos, cameraForwardXYZ, cameraPos);
 	UpdateTimeOfDay(deltaSeconds);
 	UpdateLighting();
-	UpdateVertexArrays();
+	UpdateVertexArrays(cameraPos);
 }
 
 void World::UpdateChunks(Vector3& playerPos, const Vector3& cameraForwardXYZ, const Vector3& cameraPos)
 {
+	//culling and LOD visit every chunk anyway, so the same pass collects the chunks that could be deactivated
+	bool isOverMaxChunks = m_activeChunks.GetSize() > m_maxNumChunks;
+	bool isInChunkRange = m_activeChunks.GetSize() < m_maxNumChunks && m_activeChunks.GetSize() >= m_minNumChunks;
+	m_deactivationCandidates.clear();
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		Chunk* chunk = m_activeChunks.GetChunk(chunkIndex);
+		chunk->SetFrustumCulling(cameraForwardXYZ, cameraPos);
+		float distance = CalcPlayerDistanceToChunk(playerPos, chunk->GetChunkCenterWorldCoords());
+		if (chunk->UpdateLOD(distance))
+		{
+			chunk->SetIsDirty(true);
+			QueueChunkForRemesh(chunk);
+		}
 
-	bool isDeactivatingChunk = false;
-	bool isActivatingChunk = false;
-	bool isGeneratingChunkVertex = false;
-	IntVector2 chunkCoords;
-	IntVector2 neightChunkCoords;
-	Vector3 neighborWorldCoords;
-	unsigned int direction = 0; //1 - east, 2 - north, 3 - west, 4 - south
+		if (isOverMaxChunks || (isInChunkRange && distance > m_minRangeOfActiveChunks))
+		{
+			ChunkDeactivationCandidate candidate;
+			candidate.m_chunk = chunk;
+			candidate.m_distance = distance;
+			m_deactivationCandidates.push_back(candidate);
+		}
+	}
+
+	if (DeactivateFarthestChunks(isOverMaxChunks ? m_activeChunks.GetSize() - m_maxNumChunks : CHUNK_DEACTIVATIONS_PER_FRAME) > 0)
+	{
+		SetFarthestEastBlock(playerPos);
+		return;
+	}
 
-	m_distanceToIterToManipulate = 0;
-	m_distanceToPlayer = (float) m_minRangeOfActiveChunks;
+	if (ActivateClosestChunks(playerPos) > 0)
+		SetFarthestEastBlock(playerPos);
+}
 
-	ChunkIterator chunkMapIter;
-	for (chunkMapIter = m_activeChunks.begin(); chunkMapIter != m_activeChunks.end(); ++chunkMapIter)
+int World::DeactivateFarthestChunks(int maxNumChunks)
+{
+	int numChunks = (int) m_deactivationCandidates.size();
+	if (numChunks > maxNumChunks)
+		numChunks = maxNumChunks;
+	if (numChunks > CHUNK_DEACTIVATIONS_PER_FRAME)
+		numChunks = CHUNK_DEACTIVATIONS_PER_FRAME;
+	if (numChunks <= 0)
+		return 0;
+
+	std::partial_sort(m_deactivationCandidates.begin(), m_deactivationCandidates.begin() + numChunks, m_deactivationCandidates.end(), IsFartherDeactivationCandidate);
+	for (int candidateIndex = 0; candidateIndex < numChunks; ++candidateIndex)
 	{
-		Chunk* chunk = chunkMapIter->second;
+		Chunk* chunk = m_deactivationCandidates[candidateIndex].m_chunk;
+		if (g_isSavingAndLoading)
+			SaveChunkToFile(chunk);
+		DeactivateChunk(chunk);
+	}
+	return numChunks;
+}
 
-		if (chunk == nullptr)
-			continue;
+int World::ActivateClosestChunks(Vector3& playerPos)
+{
+	//the frontier is only rekeyed when the player crosses into another chunk
+	BlockInfo playerBlockInfo;
+	m_activationFrontier.SetCenter(m_activeChunks, playerBlockInfo.GetChunkCoordsFromWorldPos(playerPos));
 
-		chunk->SetFrustumCulling(cameraForwardXYZ, cameraPos);
+	int numChunks = 0;
+	IntVector2 chunkCoords;
+	while (numChunks < CHUNK_ACTIVATIONS_PER_FRAME && m_activeChunks.GetSize() < m_minNumChunks && m_chunkPool.HasFreeChunk() && m_activationFrontier.GetClosest(m_activeChunks, chunkCoords))
+	{
+		if (CalcPlayerDistanceToChunk(playerPos, CalcChunkCenterWorldCoords(chunkCoords)) >= m_minRangeOfActiveChunks)
+			break;
 
+		m_activationFrontier.PopClosest();
+		if (!g_isSavingAndLoading || !LoadChunkFromFile(chunkCoords))
+			ActivateChunk(chunkCoords);
+		SetNeighbors(chunkCoords);
+		++numChunks;
 	}
+	return numChunks;
+}
 
-	//Amortize
-	for (chunkMapIter = m_activeChunks.begin(); chunkMapIter != m_activeChunks.end(); ++chunkMapIter)
+void World::UpdateTimeOfDay(float deltaSeconds)
+{
+	m_timeOfDay += deltaSeconds;
+	if (m_timeOfDay > DAY_LENGTH)
+		m_timeOfDay = 0.f;
+	CalcOutdoorLightLevel();
+}
+
+void World::UpdateLighting()
+{
+	UpdateLightRemoval();
+	if (m_dirtyLightingBlocks.IsEmpty())
+		return;
+
+	//rounds run until the queue settles or the frame budget is spent, a round is never cut short
+	double startSeconds = GetCurrentTimeSeconds();
+	double endSeconds = startSeconds + LIGHTING_SECONDS_PER_FRAME;
+	int numBlocksLit = 0;
+	while (!m_dirtyLightingBlocks.IsEmpty() && GetCurrentTimeSeconds() < endSeconds)
 	{
-		Chunk* chunk = chunkMapIter->second;
-		if (chunk == nullptr)
-			continue;
+		numBlocksLit += UpdateLightingRound();
+	}
 
-		if ( (int)m_activeChunks.size() > m_maxNumChunks ) //if more than max chunks
-		{
-			isDeactivatingChunk = true;
-			float distance = CalcPlayerDistanceToChunk(playerPos, chunk->GetChunkCenterWorldCoords());
-			if (distance > m_distanceToIterToManipulate)
-			{
-				m_distanceToIterToManipulate = distance;
-				m_iterToManipulate = chunkMapIter;
-			}
-		}
+	double elapsedMilliseconds = (GetCurrentTimeSeconds() - startSeconds) * 1000.0;
+	if (elapsedMilliseconds > 0.0)
+		m_lightingBlocksPerMillisecond = (float) (numBlocksLit / elapsedMilliseconds);
+}
 
-		if ( (int)m_activeChunks.size() < m_minNumChunks ) //if less than min chunks
-		{
-			float distance = 0;
-			if (chunk->m_eastNeighbor == nullptr) //NEIGHBORS
-			{
-				chunkCoords = IntVector2( chunk->GetChunkCoords() );
-				neighborWorldCoords = CalcEastNeighborCenterWorldCoords(chunkCoords);
-				distance = CalcPlayerDistanceToChunk(playerPos, neighborWorldCoords);
-				if (distance < m_distanceToPlayer)
-				{
-					m_distanceToPlayer = distance;
-					m_iterToManipulate = chunkMapIter;
-					direction = 1;
-					neightChunkCoords = chunkCoords;
-					neightChunkCoords.x++;
-					isActivatingChunk = true;
-				}
-			}
-			if (chunk->m_northNeighbor == nullptr)
-			{
-				chunkCoords = IntVector2(chunk->GetChunkCoords());
-				neighborWorldCoords = CalcNorthNeighborCenterWorldCoords(chunkCoords);
-				distance = CalcPlayerDistanceToChunk(playerPos, neighborWorldCoords);
-				if (distance < m_distanceToPlayer)
-				{
-					m_distanceToPlayer = distance;
-					m_iterToManipulate = chunkMapIter;
-					direction = 2;
-					neightChunkCoords = chunkCoords;
-					neightChunkCoords.y++;
-					isActivatingChunk = true;
-				}
-			}
-			if (chunk->m_westNeighbor == nullptr)
-			{
-				chunkCoords = IntVector2(chunk->GetChunkCoords());
-				neighborWorldCoords = CalcWestNeighborCenterWorldCoords(chunkCoords);
-				distance = CalcPlayerDistanceToChunk(playerPos, neighborWorldCoords);
-				if (distance < m_distanceToPlayer)
-				{
-					m_distanceToPlayer = distance;
-					m_iterToManipulate = chunkMapIter;
-					direction = 3;
-					neightChunkCoords = chunkCoords;
-					neightChunkCoords.x--;
-					isActivatingChunk = true;
-				}
-			}
-			if (chunk->m_southNeighbor == nullptr)
-			{
-				chunkCoords = IntVector2(chunk->GetChunkCoords());
-				neighborWorldCoords = CalcSouthNeighborCenterWorldCoords(chunkCoords);
-				distance = CalcPlayerDistanceToChunk(playerPos, neighborWorldCoords);
-				if (distance < m_distanceToPlayer)
-				{
-					m_distanceToPlayer = distance;
-					m_iterToManipulate = chunkMapIter;
-					direction = 4;
-					neightChunkCoords = chunkCoords;
-					neightChunkCoords.y--;
-					isActivatingChunk = true;
-				}
-			}
-		}
+int World::UpdateLightingRound()
+{
+	//every queued block goes to the job of its chunk, blocks of deactivated chunks are dropped
+	while (!m_dirtyLightingBlocks.IsEmpty())
+	{
+		unsigned int lightingEntry = m_dirtyLightingBlocks.PopFront();
+		Chunk* chunk = m_chunkSlots[LightingQueue::GetChunkSlotForEntry(lightingEntry)];
+		if (chunk != nullptr)
+			m_lightingSolver->AddBlock(chunk, LightingQueue::GetBlockIndexForEntry(lightingEntry));
+	}
+	m_lightingSolver->SolveJobs(m_blockDefinitions);
 
-		//Ensure all blocks are within minimum distance from the player
-		if ( ((int)m_activeChunks.size() < m_maxNumChunks) && (int)m_activeChunks.size() >= m_minNumChunks )
-		{
-			float distance = CalcPlayerDistanceToChunk(playerPos, chunk->GetChunkCenterWorldCoords());
-			if ( distance > m_minRangeOfActiveChunks && distance > m_distanceToIterToManipulate)
-			{
-				isDeactivatingChunk = true;
-				m_distanceToIterToManipulate = distance;
-				m_iterToManipulate = chunkMapIter;
-			}
+	//jobs are applied in a fixed order so the next round queues the same blocks no matter which thread solved what
+	int numBlocksLit = 0;
+	for (int jobIndex = 0; jobIndex < m_lightingSolver->GetNumJobs(); ++jobIndex)
+	{
+		ChunkLightingJob& job = m_lightingSolver->GetJob(jobIndex);
+		numBlocksLit += job.m_numBlocksSolved;
+		ApplyLightingJob(job);
+	}
+	m_lightingSolver->ClearJobs();
+	return numBlocksLit;
+}
+
+void World::ApplyLightingJob(ChunkLightingJob& job)
+{
+	Chunk* chunk = job.m_chunk;
+	if (job.m_hasLightChanged)
+		QueueChunkForRemesh(chunk);
 
-			//activate chunks in range
+	//a changed border block relights the block across the border and the faces of the neighbor that it colors
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		const std::vector< unsigned short >& changedBlockIndexes = job.m_changedBorderBlockIndexes[borderIndex];
+		for (int changedIndex = 0; changedIndex < (int) changedBlockIndexes.size(); ++changedIndex)
+		{
+			BlockInfo blockInfo(chunk, changedBlockIndexes[changedIndex]);
+			BlockInfo neighbor;
+			if (borderIndex == LIGHTING_BORDER_EAST)
+				neighbor = blockInfo.GetEastNeighbor();
+			else if (borderIndex == LIGHTING_BORDER_WEST)
+				neighbor = blockInfo.GetWestNeighbor();
+			else if (borderIndex == LIGHTING_BORDER_NORTH)
+				neighbor = blockInfo.GetNorthNeighbor();
+			else
+				neighbor = blockInfo.GetSouthNeighbor();
+
+			if (neighbor.m_chunk == nullptr)
+				continue;
+			neighbor.m_chunk->SetBlockLightIsDirty(neighbor.m_blockIndex);
+			QueueChunkForRemesh(neighbor.m_chunk);
+			AddDirtyLightingBlock(neighbor.m_chunk, neighbor.m_blockIndex);
 		}
 	}
 
-	if (isDeactivatingChunk)
+	//blocks past the per round budget are still flagged as queued, so they go back without the duplicate check
+	for (int blockIndex = job.m_numBlocksSolved; blockIndex < (int) job.m_blockIndexes.size(); ++blockIndex)
 	{
-		if (g_isSavingAndLoading)
-			SaveChunkToFile(m_iterToManipulate);
-		DeactivateChunk(m_iterToManipulate);
-		SetFarthestEastBlock(playerPos);
+		m_dirtyLightingBlocks.PushBack(LightingQueue::PackEntry(chunk->m_slotIndex, job.m_blockIndexes[blockIndex]));
+	}
+
+	if (chunk->m_numDirtyLightingBlocks == 0)
+		UpdateChunkState(chunk);
+}
+
+void World::UpdateLightRemoval()
+{
+	//removal runs to completion first so the relight never pulls from light that is about to be cleared
+	while (!m_lightRemovalBlocks.IsEmpty())
+	{
+		unsigned int lightingEntry = m_lightRemovalBlocks.PopFront();
+		int removedPackedLight = (int) m_lightRemovalBlocks.PopFront();
+		Chunk* chunk = m_chunkSlots[LightingQueue::GetChunkSlotForEntry(lightingEntry)];
+		if (chunk == nullptr)
+			continue;
+
+		BlockInfo blockInfo(chunk, LightingQueue::GetBlockIndexForEntry(lightingEntry));
+		RemoveNeighborLight(blockInfo.GetAboveNeighbor(), removedPackedLight);
+		RemoveNeighborLight(blockInfo.GetBelowNeighbor(), removedPackedLight);
+		RemoveNeighborLight(blockInfo.GetNorthNeighbor(), removedPackedLight);
+		RemoveNeighborLight(blockInfo.GetSouthNeighbor(), removedPackedLight);
+		RemoveNeighborLight(blockInfo.GetEastNeighbor(), removedPackedLight);
+		RemoveNeighborLight(blockInfo.GetWestNeighbor(), removedPackedLight);
+	}
+}
+
+void World::RemoveNeighborLight(const BlockInfo& neighbor, int removedPackedLight)
+{
+	//dimmer light may have come from the removed light, brighter light has another source and relights the cleared blocks
+	//sky and block light are separate floods, so each channel is only compared against its own removed level
+	if (neighbor.m_chunk == nullptr)
+		return;
+	const Block& block = neighbor.m_chunk->m_blocks[neighbor.m_blockIndex];
+	if (block.GetIsOpaque())
 		return;
+	int skyLightLevel = block.GetSkyLightLevel();
+	int lightLevel = block.GetLightLevel();
+	bool isRemovingSkyLight = skyLightLevel > 0 && skyLightLevel < Block::GetSkyLightLevelForPackedLight(removedPackedLight);
+	bool isRemovingLight = lightLevel > 0 && lightLevel < Block::GetLightLevelForPackedLight(removedPackedLight);
+	if (isRemovingSkyLight || isRemovingLight)
+		RemoveBlockLight(neighbor, isRemovingSkyLight, isRemovingLight);
+}
+
+void World::RemoveBlockLight(const BlockInfo& blockInfo, bool isRemovingSkyLight, bool isRemovingLight)
+{
+	//the block is cleared and queued to pull its light back from whatever still lights it
+	Block& block = blockInfo.m_chunk->m_blocks[blockInfo.m_blockIndex];
+	int removedSkyLightLevel = 0;
+	int removedLightLevel = 0;
+	if (isRemovingSkyLight)
+	{
+		removedSkyLightLevel = block.GetSkyLightLevel();
+		block.SetSkyLightLevel(0);
+	}
+	if (isRemovingLight)
+	{
+		removedLightLevel = block.GetLightLevel();
+		block.SetLightLevel(0);
 	}
 
-	if (isActivatingChunk)
+	if (removedSkyLightLevel > 0 || removedLightLevel > 0)
 	{
-		if (!g_isSavingAndLoading) 
-			ActivateChunk(neightChunkCoords);
-		else if( !LoadChunkFromFile(neightChunkCoords) )
-			ActivateChunk(neightChunkCoords);
-		SetNeighbors(neightChunkCoords);
-		SetFarthestEastBlock(playerPos);
+		if (blockInfo.m_chunk->m_slotIndex < 0)
+			AssignChunkSlot(blockInfo.m_chunk);
+		m_lightRemovalBlocks.PushBack(LightingQueue::PackEntry(blockInfo.m_chunk->m_slotIndex, blockInfo.m_blockIndex));
+		m_lightRemovalBlocks.PushBack((unsigned int) Block::PackLight(removedSkyLightLevel, removedLightLevel));
+		SetBlockLightDirty(blockInfo);
+	}
+	AddDirtyLightingBlock(blockInfo.m_chunk, blockInfo.m_blockIndex);
+}
+
+void World::UpdateBlockLighting(unsigned int lightingEntry)
+{
+	//entries for deactivated chunks and blocks already lit through a duplicate are skipped
+	Chunk* chunk = m_chunkSlots[LightingQueue::GetChunkSlotForEntry(lightingEntry)];
+	if (chunk == nullptr)
+		return;
+	BlockInfo blockInfo(chunk, LightingQueue::GetBlockIndexForEntry(lightingEntry));
+	Block* block = blockInfo.GetBlock();
+	if (!block->GetIsLightingDirty())
 		return;
+	block->SetIsLightingDirty(false);
+	--chunk->m_numDirtyLightingBlocks;
+
+	int neighborPackedLights[BLOCK_FACE_SIZE];
+	int numNeighbors = 0;
+	if (!block->GetIsOpaque())
+	{
+		AddNeighborPackedLight(blockInfo.GetAboveNeighbor(), neighborPackedLights, numNeighbors);
+		AddNeighborPackedLight(blockInfo.GetBelowNeighbor(), neighborPackedLights, numNeighbors);
+		AddNeighborPackedLight(blockInfo.GetNorthNeighbor(), neighborPackedLights, numNeighbors);
+		AddNeighborPackedLight(blockInfo.GetSouthNeighbor(), neighborPackedLights, numNeighbors);
+		AddNeighborPackedLight(blockInfo.GetEastNeighbor(), neighborPackedLights, numNeighbors);
+		AddNeighborPackedLight(blockInfo.GetWestNeighbor(), neighborPackedLights, numNeighbors);
 	}
+	int originalPackedLight = block->GetPackedLight();
+	int selfIllumination = m_blockDefinitions[block->GetBlockType()]->GetSelfIllumination();
+	block->SetPackedLight(Block::CalcPulledPackedLight(block->GetIsOpaque(), chunk->IsBlockSky(blockInfo.m_blockIndex), selfIllumination, neighborPackedLights, numNeighbors));
 
-	m_distanceToIterToManipulate = 2000;
-	for (chunkMapIter = m_activeChunks.begin(); chunkMapIter != m_activeChunks.end(); ++chunkMapIter)
+	if (originalPackedLight != block->GetPackedLight())
 	{
-		Chunk* chunk = chunkMapIter->second;
+		SetBlockNeighborsDirty(&blockInfo);
+		SetBlockLightDirty(blockInfo);
+	}
 
-		if (chunk == nullptr)
-			continue;
+	if (chunk->m_numDirtyLightingBlocks == 0)
+		UpdateChunkState(chunk);
+}
 
-		//Ensure that all chunks' vertex arrays have been generated
-		float distance = CalcPlayerDistanceToChunk(playerPos, chunk->GetChunkCenterWorldCoords());
-		if ( chunk->IsChunkDirty() && distance < m_distanceToIterToManipulate )
+void World::AddNeighborPackedLight(const BlockInfo& neighbor, int neighborPackedLights[], int& numNeighbors)
+{
+	if (neighbor.m_chunk == nullptr)
+		return;
+
+	neighborPackedLights[numNeighbors] = neighbor.m_chunk->m_blocks[neighbor.m_blockIndex].GetPackedLight();
+	++numNeighbors;
+}
+
+void World::UpdateVertexArrays(const Vector3& cameraPos)
+{
+	int numBytesUploaded = UploadCompletedMeshes();
+	ScheduleRemeshes(cameraPos, MESH_UPLOAD_BYTES_PER_FRAME - numBytesUploaded);
+}
+
+void World::ScheduleRemeshes(const Vector3& cameraPos, int maxBytesToUpload)
+{
+	//light only changes reuse the existing geometry and share the upload budget with new meshes
+	m_remeshScheduler.UpdatePriorities(cameraPos);
+	double endSeconds = GetCurrentTimeSeconds() + m_remeshScheduler.GetSecondsPerFrame();
+	int numBytesUploaded = 0;
+	while (!m_remeshScheduler.IsEmpty() && GetCurrentTimeSeconds() < endSeconds)
+	{
+		Chunk* chunk = m_remeshScheduler.GetNextChunk();
+		if (chunk->IsChunkDirty())
 		{
-			m_distanceToIterToManipulate = distance;
-			m_iterToManipulate = chunkMapIter;
-			isGeneratingChunkVertex = true;
+			if (!CanQueueChunkMeshJob())
+				return;
+			QueueChunkMeshJob(chunk);
 		}
 
+		numBytesUploaded += chunk->RecolorLightDirtySections(maxBytesToUpload - numBytesUploaded);
+		if (numBytesUploaded >= maxBytesToUpload && chunk->IsLightDirty())
+			return;
+
+		//sections still waiting on a mesh job are requeued when the job is uploaded
+		m_remeshScheduler.PopNextChunk();
 	}
+}
+
+void World::QueueChunkForRemesh(Chunk* chunk)
+{
+	//chunks still waiting on light or neighbors keep their dirty sections until they are ready
+	if (chunk->GetState() < CHUNK_STATE_NEIGHBORS_READY)
+		return;
+	m_remeshScheduler.QueueChunk(chunk);
+}
 
-	if (isGeneratingChunkVertex)
+void World::UpdateChunkState(Chunk* chunk)
+{
+	if (chunk->GetState() == CHUNK_STATE_GENERATED && chunk->m_numDirtyLightingBlocks == 0)
+		chunk->SetState(CHUNK_STATE_LIT);
+
+	if (chunk->GetState() == CHUNK_STATE_LIT && chunk->HasAllNeighbors())
 	{
-		m_iterToManipulate->second->GenerateVertexArray();
+		chunk->SetState(CHUNK_STATE_NEIGHBORS_READY);
+		QueueChunkForRemesh(chunk);
+	}
+}
+
+void World::QueueChunkMeshJob(Chunk* chunk)
+{
+	//the snapshot is taken here on the main thread so the worker never touches live chunks
+	ChunkMeshInput* meshInput = nullptr;
+	ChunkMeshResult* meshResult = nullptr;
+	CreateChunkMeshJob(chunk, meshInput, meshResult);
+	if (ApplyCachedChunkMesh(chunk, meshInput, meshResult))
 		return;
+
+	++m_numChunkMeshJobs;
+	++m_numMeshJobsInFlight;
+	m_meshWorkers->AddJob(&World::RunChunkMeshJob, this, meshInput, meshResult);
+}
+
+void World::CreateChunkMeshJob(Chunk* chunk, ChunkMeshInput*& meshInput, ChunkMeshResult*& meshResult)
+{
+	int numAllocations = 0;
+	meshInput = m_meshArena.AcquireMeshInput(numAllocations);
+	meshResult = m_meshArena.AcquireMeshResult(numAllocations);
+	meshResult->m_numAllocations = numAllocations;
+	++m_nextMeshJobID;
+	chunk->CreateMeshInput(*meshInput, m_nextMeshJobID);
+}
+
+bool World::ApplyCachedChunkMesh(Chunk* chunk, ChunkMeshInput* meshInput, ChunkMeshResult* meshResult)
+{
+	//a chunk reloaded unchanged since it was saved uploads its cached vertexes instead of meshing
+	if (!chunk->m_hasCachedMesh)
+		return false;
+	chunk->m_hasCachedMesh = false;
+	if (!m_meshCache.LoadChunkMesh(*meshInput, *meshResult))
+		return false;
+
+	m_meshArena.ReleaseMeshInput(meshInput);
+	ApplyChunkMeshResult(chunk, *meshResult);
+	m_meshArena.AddRemeshAllocations(meshResult->m_numAllocations);
+	m_meshArena.ReleaseMeshResult(meshResult);
+	return true;
+}
+
+void World::RunChunkMeshJob(void* jobOwner, void* jobInput, void* jobOutput)
+{
+	World* world = (World*) jobOwner;
+	world->BuildChunkMesh((ChunkMeshInput*) jobInput, (ChunkMeshResult*) jobOutput);
+}
+
+void World::BuildChunkMesh(ChunkMeshInput* meshInput, ChunkMeshResult* meshResult)
+{
+	ChunkMeshBuilder meshBuilder(*meshInput);
+	meshBuilder.BuildMesh(*meshResult);
+	m_meshArena.ReleaseMeshInput(meshInput);
+
+	std::lock_guard< std::mutex > lock(m_completedMeshesMutex);
+	m_completedMeshes.PushBack(meshResult);
+}
+
+int World::UploadCompletedMeshes()
+{
+	int numBytesUploaded = 0;
+	while (numBytesUploaded < MESH_UPLOAD_BYTES_PER_FRAME)
+	{
+		ChunkMeshResult* meshResult = nullptr;
+		{
+			std::lock_guard< std::mutex > lock(m_completedMeshesMutex);
+			if (m_completedMeshes.IsEmpty())
+				return numBytesUploaded;
+			meshResult = m_completedMeshes.PopFront();
+		}
+		--m_numMeshJobsInFlight;
+
+		//results for deactivated chunks are dropped, the chunk skips sections superseded by a newer snapshot
+		Chunk* chunk = m_activeChunks.Find(meshResult->m_chunkCoords);
+		if (chunk != nullptr)
+		{
+			numBytesUploaded += ApplyChunkMeshResult(chunk, *meshResult);
+			if (chunk->IsChunkDirty() || chunk->IsLightDirty())
+				QueueChunkForRemesh(chunk);
+		}
+		m_meshArena.AddRemeshAllocations(meshResult->m_numAllocations);
+		m_meshArena.ReleaseMeshResult(meshResult);
 	}
+	return numBytesUploaded;
 }
 
-void World::UpdateTimeOfDay(float deltaSeconds)
+int World::ApplyChunkMeshResult(Chunk* chunk, ChunkMeshResult& meshResult)
 {
-	m_timeOfDay += deltaSeconds;
-	if (m_timeOfDay > DAY_LENGTH)
-		m_timeOfDay = 0.f;
-	CalcOutdoorLightLevel();
+	int numBytesUploaded = chunk->ApplyMeshResult(meshResult);
+	if (chunk->GetState() == CHUNK_STATE_NEIGHBORS_READY)
+		chunk->SetState(CHUNK_STATE_MESHED);
+	return numBytesUploaded;
 }
 
-void World::UpdateLighting()
+void World::RemeshChunkNow(Chunk* chunk)
 {
-	if (m_dirtyLightingBlocks.empty())
+	//chunks that were never meshed keep waiting for their neighbors
+	if (chunk->GetState() < CHUNK_STATE_NEIGHBORS_READY)
 		return;
 
-	//set west block lighting
-	m_farthestEastChunk->m_blocks[NUM_BLOCKS_PER_CHUNK - 1].GetIsLightingDirty();
-	int numLightingLoops = NUM_BLOCKS_PER_CHUNK * 2;
-	if ( (int) m_dirtyLightingBlocks.size() < numLightingLoops )
-		numLightingLoops = (int) m_dirtyLightingBlocks.size();
-
-	for (int dirtyLightsCount = 0; dirtyLightsCount < numLightingLoops; --numLightingLoops)
+	if (chunk->IsChunkDirty())
 	{
-		if (m_dirtyLightingBlocks.empty())
-			return;
+		//a newer job id supersedes any result for these sections still in flight
+		ChunkMeshInput* meshInput = nullptr;
+		ChunkMeshResult* meshResult = nullptr;
+		CreateChunkMeshJob(chunk, meshInput, meshResult);
+		++m_numChunkMeshJobs;
+		ChunkMeshBuilder meshBuilder(*meshInput);
+		meshBuilder.BuildMesh(*meshResult);
+		m_meshArena.ReleaseMeshInput(meshInput);
+		ApplyChunkMeshResult(chunk, *meshResult);
+		m_meshArena.AddRemeshAllocations(meshResult->m_numAllocations);
+		m_meshArena.ReleaseMeshResult(meshResult);
+	}
+	chunk->RecolorLightDirtySections(MESH_UPLOAD_BYTES_PER_FRAME);
+}
 
-		BlockInfo* blockInfo = m_dirtyLightingBlocks[dirtyLightsCount];
-		if (blockInfo->m_chunk == nullptr || blockInfo == nullptr)
-			return;
-		Block* block = blockInfo->GetBlock();
-		int originalLightLevel = block->GetLightLevel();
+bool World::CanQueueChunkMeshJob() const
+{
+	return m_numMeshJobsInFlight < m_meshWorkers->GetNumWorkers() * MESH_JOBS_IN_FLIGHT_PER_WORKER;
+}
 
-		if (block->GetIsOpaque())
+void World::SetAllChunksDirty()
+{
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		Chunk* chunk = m_activeChunks.GetChunk(chunkIndex);
+		chunk->SetIsDirty(true);
+		QueueChunkForRemesh(chunk);
+	}
+}
+
+void World::RunMeshBenchmark()
+{
+	//meshes every active chunk on this thread with per block and bitmask face culling
+	ChunkMeshInput* meshInput = new ChunkMeshInput();
+	ChunkMeshResult meshResult;
+	meshResult.m_numAllocations = 0;
+	double secondsForBlockCulling = 0.0;
+	double secondsForMaskCulling = 0.0;
+	int numChunks = 0;
+
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		m_activeChunks.GetChunk(chunkIndex)->CopyToMeshInput(*meshInput);
+		meshInput->m_lod = CHUNK_LOD_FULL;
+		for (int cullingIndex = 0; cullingIndex < 2; ++cullingIndex)
 		{
-			block->SetLightLevel( m_blockDefinitions[block->GetBlockType()]->GetSelfIllumination() );
+			meshInput->m_isMaskCulling = cullingIndex == 1;
+			double startSeconds = GetCurrentTimeSeconds();
+			for (int runIndex = 0; runIndex < MESH_BENCHMARK_RUNS_PER_CHUNK; ++runIndex)
+			{
+				ChunkMeshBuilder meshBuilder(*meshInput);
+				meshBuilder.BuildMesh(meshResult);
+			}
+			double elapsedSeconds = GetCurrentTimeSeconds() - startSeconds;
+			if (meshInput->m_isMaskCulling)
+				secondsForMaskCulling += elapsedSeconds;
+			else
+				secondsForBlockCulling += elapsedSeconds;
 		}
+		++numChunks;
+	}
+	delete meshInput;
+
+	if (numChunks == 0)
+		return;
+
+	float millisecondsPerRun = 1000.f / (float) (numChunks * MESH_BENCHMARK_RUNS_PER_CHUNK);
+	m_meshBenchmarkBlockMilliseconds = (float) secondsForBlockCulling * millisecondsPerRun;
+	m_meshBenchmarkMaskMilliseconds = (float) secondsForMaskCulling * millisecondsPerRun;
+	DebuggerPrintf("Mesh benchmark over %i chunks: per block %.3f ms, bitmask %.3f ms per chunk\n", numChunks, m_meshBenchmarkBlockMilliseconds, m_meshBenchmarkMaskMilliseconds);
+}
+
+void World::RunLightingCheck()
+{
+	//random edits near the surface are relit incrementally, undone in reverse, and both results compared against a full recompute
+	SettleLighting();
+	BlockInfo editedBlockInfos[LIGHTING_CHECK_NUM_EDITS];
+	unsigned char originalBlockTypes[LIGHTING_CHECK_NUM_EDITS];
+	int numEdits = 0;
+	double startSeconds = GetCurrentTimeSeconds();
+	for (int attemptIndex = 0; attemptIndex < LIGHTING_CHECK_NUM_EDITS * 2 && numEdits < LIGHTING_CHECK_NUM_EDITS; ++attemptIndex)
+	{
+		if (EditRandomBlockForLightingCheck(editedBlockInfos[numEdits], originalBlockTypes[numEdits]))
+			++numEdits;
+	}
+	SettleLighting();
+	double relightSeconds = GetCurrentTimeSeconds() - startSeconds;
+	if (numEdits == 0)
+		return;
+
+	double recomputeStartSeconds = GetCurrentTimeSeconds();
+	int numMismatches = CountLightingMismatches();
+	double recomputeSeconds = GetCurrentTimeSeconds() - recomputeStartSeconds;
+
+	startSeconds = GetCurrentTimeSeconds();
+	for (int editIndex = numEdits - 1; editIndex >= 0; --editIndex)
+	{
+		if (originalBlockTypes[editIndex] == BLOCK_TYPE_AIR)
+			RemoveBlockAtClosestNonOpaqueBlock(editedBlockInfos[editIndex]);
 		else
+			PlaceBlockAtFarthestOpaqueBlock(editedBlockInfos[editIndex], originalBlockTypes[editIndex]);
+	}
+	SettleLighting();
+	relightSeconds += GetCurrentTimeSeconds() - startSeconds;
+	numMismatches += CountLightingMismatches();
+
+	m_lightingCheckNumEdits = numEdits;
+	m_lightingCheckNumMismatches = numMismatches;
+	m_lightingCheckRelightMilliseconds = (float) (relightSeconds * 1000.0);
+	m_lightingCheckRecomputeMilliseconds = (float) (recomputeSeconds * 1000.0);
+	DebuggerPrintf("Lighting check over %i edits and their undo: %i mismatched blocks, relight %.3f ms, full recompute %.3f ms\n", numEdits, numMismatches, m_lightingCheckRelightMilliseconds, m_lightingCheckRecomputeMilliseconds);
+}
+
+bool World::EditRandomBlockForLightingCheck(BlockInfo& editedBlockInfo, unsigned char& originalBlockType)
+{
+	//a block a few above or below the surface of a random column is dug out, or filled with stone or glowstone
+	Chunk* chunk = m_activeChunks.GetChunk(rand() % m_activeChunks.GetSize());
+	int columnIndex = rand() % CHUNK_BLOCKS_PER_LAYER;
+	int surfaceZ = 0;
+	for (int blockZ = CHUNK_BLOCKS_TALL_Z - 1; blockZ >= 0; --blockZ)
+	{
+		if (chunk->m_blocks[columnIndex | (blockZ << CHUNK_BITS_XY)].GetIsOpaque())
 		{
-			if (block->GetIsSky())
-			{
-// 				char skyLightLevelForChunk = GetSkyLightLevelForChunkCoords(blockInfo->m_chunk->GetChunkCoords());
-				//find sky light level based on position from west most block
-				block->SetLightLevel( m_outdoorLightLevel );
-			}
+			surfaceZ = blockZ;
+			break;
+		}
+	}
+	int blockZ = surfaceZ - 3 + (rand() % 6);
+	if (blockZ < 1)
+		blockZ = 1;
+	if (blockZ > CHUNK_BLOCKS_TALL_Z - 2)
+		blockZ = CHUNK_BLOCKS_TALL_Z - 2;
+	editedBlockInfo = BlockInfo(chunk, columnIndex | (blockZ << CHUNK_BITS_XY));
+	Block* block = editedBlockInfo.GetBlock();
+	originalBlockType = block->GetBlockType();
+	if (block->GetIsOpaque())
+	{
+		RemoveBlockAtClosestNonOpaqueBlock(editedBlockInfo);
+		return true;
+	}
+	if (originalBlockType != BLOCK_TYPE_AIR)
+		return false;
 
-			if (m_blockDefinitions[block->GetBlockType()]->GetSelfIllumination() > block->GetLightLevel())
-			{
-				block->SetLightLevel(m_blockDefinitions[block->GetBlockType()]->GetSelfIllumination());
-			}
+	PlaceBlockAtFarthestOpaqueBlock(editedBlockInfo, (rand() % 3 == 0) ? BLOCK_TYPE_GLOWSTONE : BLOCK_TYPE_STONE);
+	return true;
+}
 
-			BlockInfo neighbor;
-			neighbor = blockInfo->GetAboveNeighbor();
-			if (neighbor.m_chunk != nullptr)
-			{
-				int neighborLightLevel = neighbor.GetBlock()->GetLightLevel();
-				if (neighborLightLevel - 1 > block->GetLightLevel())
-				{
-					block->SetLightLevel(neighborLightLevel - 1);
-				}
-			}
+void World::SettleLighting()
+{
+	while (!m_lightRemovalBlocks.IsEmpty() || !m_dirtyLightingBlocks.IsEmpty())
+	{
+		UpdateLighting();
+	}
+}
 
-			neighbor = blockInfo->GetBelowNeighbor();
-			if (neighbor.m_chunk != nullptr)
-			{
-				int neighborLightLevel = neighbor.GetBlock()->GetLightLevel();
-				if (neighborLightLevel - 1 > block->GetLightLevel())
-				{
-					block->SetLightLevel(neighborLightLevel - 1);
-				}
-			}
+int World::CountLightingMismatches()
+{
+	std::vector< std::vector< unsigned char > > lightLevels;
+	std::vector< std::vector< unsigned char > > skyLightLevels;
+	RecomputeLightLevels(lightLevels, false);
+	RecomputeLightLevels(skyLightLevels, true);
 
-			neighbor = blockInfo->GetNorthNeighbor();
-			if (neighbor.m_chunk != nullptr)
-			{
-				int neighborLightLevel = neighbor.GetBlock()->GetLightLevel();
-				if (neighborLightLevel - 1 > block->GetLightLevel())
-				{
-					block->SetLightLevel(neighborLightLevel - 1);
-				}
-			}
+	int numMismatches = 0;
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		Chunk* chunk = m_activeChunks.GetChunk(chunkIndex);
+		const std::vector< unsigned char >& chunkLightLevels = lightLevels[chunk->m_slotIndex];
+		const std::vector< unsigned char >& chunkSkyLightLevels = skyLightLevels[chunk->m_slotIndex];
+		for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+		{
+			const Block& block = chunk->m_blocks[blockIndex];
+			if (block.GetLightLevel() != chunkLightLevels[blockIndex] || block.GetSkyLightLevel() != chunkSkyLightLevels[blockIndex])
+				++numMismatches;
+		}
+	}
+	return numMismatches;
+}
 
-			neighbor = blockInfo->GetSouthNeighbor();
-			if (neighbor.m_chunk != nullptr)
+void World::RecomputeLightLevels(std::vector< std::vector< unsigned char > >& lightLevels, bool isSkyLight) const
+{
+	//every source is seeded at full strength and flooded through non opaque blocks, nothing the incremental lighting stored is read
+	LightingQueue floodBlocks;
+	lightLevels.resize(m_chunkSlots.size());
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		Chunk* chunk = m_activeChunks.GetChunk(chunkIndex);
+		std::vector< unsigned char >& chunkLightLevels = lightLevels[chunk->m_slotIndex];
+		chunkLightLevels.assign(NUM_BLOCKS_PER_CHUNK, 0);
+		if (isSkyLight)
+		{
+			//sky flags are recomputed from the blocks too, a column is sky down to its first opaque block
+			for (int columnIndex = 0; columnIndex < CHUNK_BLOCKS_PER_LAYER; ++columnIndex)
 			{
-				int neighborLightLevel = neighbor.GetBlock()->GetLightLevel();
-				if (neighborLightLevel - 1 > block->GetLightLevel())
+				for (int blockZ = CHUNK_BLOCKS_TALL_Z - 1; blockZ >= 0; --blockZ)
 				{
-					block->SetLightLevel(neighborLightLevel - 1);
+					int blockIndex = columnIndex | (blockZ << CHUNK_BITS_XY);
+					if (chunk->m_blocks[blockIndex].GetIsOpaque())
+						break;
+					chunkLightLevels[blockIndex] = MASK_LIGHT;
+					floodBlocks.PushBack(LightingQueue::PackEntry(chunk->m_slotIndex, blockIndex));
 				}
 			}
-
-			neighbor = blockInfo->GetEastNeighbor();
-			if (neighbor.m_chunk != nullptr)
+		}
+		else
+		{
+			for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
 			{
-				int neighborLightLevel = neighbor.GetBlock()->GetLightLevel();
-				if (neighborLightLevel - 1 > block->GetLightLevel())
-				{
-					block->SetLightLevel(neighborLightLevel - 1);
-				}
+				int selfIllumination = m_blockDefinitions[chunk->m_blocks[blockIndex].GetBlockType()]->GetSelfIllumination();
+				if (selfIllumination == 0)
+					continue;
+				chunkLightLevels[blockIndex] = (unsigned char) selfIllumination;
+				floodBlocks.PushBack(LightingQueue::PackEntry(chunk->m_slotIndex, blockIndex));
 			}
+		}
+	}
 
-			neighbor = blockInfo->GetWestNeighbor();
-			if (neighbor.m_chunk != nullptr)
-			{
-				int neighborLightLevel = neighbor.GetBlock()->GetLightLevel();
-				if (neighborLightLevel - 1 > block->GetLightLevel())
-				{
-					block->SetLightLevel(neighborLightLevel - 1);
-				}
-			}
+	while (!floodBlocks.IsEmpty())
+	{
+		unsigned int floodEntry = floodBlocks.PopFront();
+		int chunkSlot = LightingQueue::GetChunkSlotForEntry(floodEntry);
+		int blockIndex = LightingQueue::GetBlockIndexForEntry(floodEntry);
+		int neighborLightLevel = lightLevels[chunkSlot][blockIndex] - 1;
+		if (neighborLightLevel <= 0)
+			continue;
+
+		BlockInfo blockInfo(m_chunkSlots[chunkSlot], blockIndex);
+		BlockInfo neighbors[BLOCK_FACE_SIZE] = { blockInfo.GetAboveNeighbor(), blockInfo.GetBelowNeighbor(), blockInfo.GetNorthNeighbor(), blockInfo.GetSouthNeighbor(), blockInfo.GetEastNeighbor(), blockInfo.GetWestNeighbor() };
+		for (int neighborIndex = 0; neighborIndex < BLOCK_FACE_SIZE; ++neighborIndex)
+		{
+			BlockInfo& neighbor = neighbors[neighborIndex];
+			if (neighbor.m_chunk == nullptr || neighbor.GetBlock()->GetIsOpaque())
+				continue;
+			unsigned char& lightLevel = lightLevels[neighbor.m_chunk->m_slotIndex][neighbor.m_blockIndex];
+			if (lightLevel >= neighborLightLevel)
+				continue;
+			lightLevel = (unsigned char) neighborLightLevel;
+			floodBlocks.PushBack(LightingQueue::PackEntry(neighbor.m_chunk->m_slotIndex, neighbor.m_blockIndex));
 		}
+	}
+}
+
+void World::RunLightingSolverCheck(Vector3& playerPos)
+{
+	//the chunks around the player are relit from scratch one block at a time through the edit path, then by the solver on the main thread alone, then again with helpers, and the light compared
+	SettleLighting();
+	std::vector< Chunk* > chunks;
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		Chunk* chunk = m_activeChunks.GetChunk(chunkIndex);
+		if (CalcPlayerDistanceToChunk(playerPos, CalcChunkCenterWorldCoords(chunk->GetChunkCoords())) < LIGHTING_SOLVER_CHECK_RANGE)
+			chunks.push_back(chunk);
+	}
+	if (chunks.empty())
+		return;
+
+	RelightChunksFromScratch(chunks, true);
+	std::vector< int > editPackedLights;
+	CopyChunkPackedLights(chunks, editPackedLights);
+
+	m_lightingSolver->SetIsSerial(true);
+	double serialSeconds = RelightChunksFromScratch(chunks, false);
+	m_lightingSolver->SetIsSerial(false);
+	int numEditMismatches = CountPackedLightMismatches(chunks, editPackedLights);
+	std::vector< int > serialPackedLights;
+	CopyChunkPackedLights(chunks, serialPackedLights);
+
+	int startNumHelperJoins = m_lightingSolver->GetNumHelperJoins();
+	double parallelSeconds = RelightChunksFromScratch(chunks, false);
+	int numMismatches = CountPackedLightMismatches(chunks, serialPackedLights);
+
+	m_solverCheckNumChunks = (int) chunks.size();
+	m_solverCheckNumMismatches = numMismatches;
+	m_solverCheckNumEditMismatches = numEditMismatches;
+	m_solverCheckNumHelperJoins = m_lightingSolver->GetNumHelperJoins() - startNumHelperJoins;
+	m_solverCheckSerialMilliseconds = (float) (serialSeconds * 1000.0);
+	m_solverCheckParallelMilliseconds = (float) (parallelSeconds * 1000.0);
+	DebuggerPrintf("Lighting solver check over %i chunks: serial %.3f ms, parallel %.3f ms with %i helper joins on %i workers, %i blocks differ from edit relighting, %i parallel blocks differ from serial\n", m_solverCheckNumChunks, m_solverCheckSerialMilliseconds, m_solverCheckParallelMilliseconds, m_solverCheckNumHelperJoins, m_meshWorkers->GetNumWorkers(), m_solverCheckNumEditMismatches, m_solverCheckNumMismatches);
+}
 
-		if (originalLightLevel != block->GetLightLevel())
+double World::RelightChunksFromScratch(const std::vector< Chunk* >& chunks, bool isRelightingEdit)
+{
+	//light from chunks outside the set is left alone, so every run starts from the same borders
+	m_isRelightingEdit = isRelightingEdit;
+	for (int chunkIndex = 0; chunkIndex < (int) chunks.size(); ++chunkIndex)
+	{
+		Chunk* chunk = chunks[chunkIndex];
+		for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
 		{
-			SetBlockNeighborsDirty(blockInfo);
-			blockInfo->m_chunk->SetIsDirty(true);
+			chunk->m_blocks[blockIndex].SetPackedLight(0);
+			AddDirtyLightingBlock(chunk, blockIndex);
 		}
-		block->SetIsLightingDirty(false);
+	}
 
-		delete m_dirtyLightingBlocks[dirtyLightsCount];
-		m_dirtyLightingBlocks[dirtyLightsCount] = nullptr;
-		m_dirtyLightingBlocks.pop_front();
+	double startSeconds = GetCurrentTimeSeconds();
+	if (isRelightingEdit)
+	{
+		//same per block update the edit keys use, with no budget so it runs until the light settles
+		while (!m_editLightingBlocks.IsEmpty())
+		{
+			UpdateBlockLighting(m_editLightingBlocks.PopFront());
+		}
+		m_isRelightingEdit = false;
 	}
+	SettleLighting();
+	return GetCurrentTimeSeconds() - startSeconds;
 }
 
-void World::UpdateVertexArrays()
+void World::CopyChunkPackedLights(const std::vector< Chunk* >& chunks, std::vector< int >& packedLights) const
 {
-	std::map<IntVector2, Chunk*>::iterator iter;
-	for (iter = m_activeChunks.begin(); iter != m_activeChunks.end(); ++iter)
+	packedLights.resize(chunks.size() * NUM_BLOCKS_PER_CHUNK);
+	for (int chunkIndex = 0; chunkIndex < (int) chunks.size(); ++chunkIndex)
 	{
-		Chunk* chunk = iter->second;
+		for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
+		{
+			packedLights[(chunkIndex * NUM_BLOCKS_PER_CHUNK) + blockIndex] = chunks[chunkIndex]->m_blocks[blockIndex].GetPackedLight();
+		}
+	}
+}
 
-		if (chunk != nullptr && chunk->IsChunkDirty())
+int World::CountPackedLightMismatches(const std::vector< Chunk* >& chunks, const std::vector< int >& packedLights) const
+{
+	int numMismatches = 0;
+	for (int chunkIndex = 0; chunkIndex < (int) chunks.size(); ++chunkIndex)
+	{
+		for (int blockIndex = 0; blockIndex < NUM_BLOCKS_PER_CHUNK; ++blockIndex)
 		{
-			chunk->GenerateVertexArray();
-			return;
+			if (chunks[chunkIndex]->m_blocks[blockIndex].GetPackedLight() != packedLights[(chunkIndex * NUM_BLOCKS_PER_CHUNK) + blockIndex])
+				++numMismatches;
 		}
 	}
+	return numMismatches;
+}
+
+void World::ResetStreamingCounters()
+{
+	m_numChunksGenerated = 0;
+	m_numChunkMeshJobs = 0;
+}
+
+float World::CalcMeshesPerChunk() const
+{
+	if (m_numChunksGenerated == 0)
+		return 0.f;
+	return (float) m_numChunkMeshJobs / (float) m_numChunksGenerated;
 }
 
 void World::Render() const
@@ -460,13 +993,12 @@ void World::Render() const
 	RenderAxes(3.f, 1.f);
 	g_theRenderer->BindTexture2D(m_tileSheet->GetSpriteSheetTexture());
 
-	std::map<IntVector2, Chunk*>::const_iterator iter;
-	for (iter = m_activeChunks.begin(); iter != m_activeChunks.end(); ++iter)
+	m_tileShader.Bind(m_outdoorLightLevel);
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
 	{
-		Chunk* chunk = iter->second;
-		if (chunk != nullptr)
-			chunk->Render();
+		m_activeChunks.GetChunk(chunkIndex)->Render();
 	}
+	m_tileShader.Unbind();
 
 	RenderAxes(1.f, 0.3f);
 }
@@ -489,12 +1021,11 @@ void World::RenderAxes(float lineThickness, float alphaAmount) const
 	g_theRenderer->DrawLine3D(Vector3(0.f, 0.f, 0.f), Vector3(0.f, 0.f, 2.f), color, color);
 }
 
-void World::SaveChunkToFile(const ChunkIterator& iter)
+void World::SaveChunkToFile(Chunk* chunk)
 {
-	Chunk* chunk = iter->second;
-
 	std::vector< unsigned char > chunkData;
 	chunk->GetRLEBlockData(chunkData);
+	chunk->AppendRLELightData(chunkData, IsChunkLightSettled(chunk));
 
 	IntVector2 chunkCoords = IntVector2(chunk->GetChunkCoords());
 	chunkData.insert(chunkData.begin(), (unsigned char) CHUNK_BLOCKS_TALL_Z);
@@ -504,6 +1035,29 @@ void World::SaveChunkToFile(const ChunkIterator& iter)
 
 	std::string fileName = Stringf("Data/Saves/Chunk_at_(%i,%i).chunk", chunkCoords.x, chunkCoords.y);
 	SaveBinaryFileFromBuffer(fileName, chunkData);
+
+	if (g_isMeshCaching)
+	{
+		int numAllocations = 0;
+		ChunkMeshInput* meshInput = m_meshArena.AcquireMeshInput(numAllocations);
+		chunk->CopyToMeshInput(*meshInput);
+		m_meshCache.SaveChunkMesh(*chunk, *meshInput);
+		m_meshArena.ReleaseMeshInput(meshInput);
+	}
+}
+
+bool World::IsChunkLightSettled(const Chunk* chunk) const
+{
+	//the neighbor faces are saved with the light, so they must not be waiting on the queue either
+	if (!m_lightRemovalBlocks.IsEmpty() || chunk->m_numDirtyLightingBlocks > 0)
+		return false;
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		const Chunk* neighbor = chunk->GetNeighbor((LightingBorder) borderIndex);
+		if (neighbor != nullptr && neighbor->m_numDirtyLightingBlocks > 0)
+			return false;
+	}
+	return true;
 }
 
 bool World::LoadChunkFromFile(IntVector2 chunkCoords)
@@ -512,26 +1066,39 @@ bool World::LoadChunkFromFile(IntVector2 chunkCoords)
 	std::string fileName = Stringf("Data/Saves/Chunk_at_(%i,%i).chunk", chunkCoords.x, chunkCoords.y);
 	if (!LoadBinaryFileToBuffer(fileName, chunkData))
 		return false;
-	if (chunkData[0] != m_fileVersionNumber)
+	if (chunkData.empty() || (chunkData[0] != m_fileVersionNumber && chunkData[0] != CHUNK_FILE_VERSION_WITHOUT_LIGHT))
 		return false;
 
-	m_activeChunks[chunkCoords] = new Chunk(chunkCoords, m_blockDefinitions, chunkData);
+	Chunk* chunk = m_chunkPool.AcquireChunk();
+	chunk->Reset(chunkCoords, m_blockDefinitions, chunkData);
+	chunk->m_hasCachedMesh = g_isMeshCaching;
+	if (chunk->m_slotIndex < 0)
+		AssignChunkSlot(chunk);
+	if (!chunk->m_hasSavedLight)
+		m_lightFlood.FloodChunk(*chunk, m_blockDefinitions);
+	m_activeChunks.Insert(chunkCoords, chunk);
+	m_activationFrontier.AddMissingNeighbors(m_activeChunks, chunkCoords);
+	++m_numChunksGenerated;
 	return true;
 }
 
 void World::SaveAllChunks()
 {
-	std::map<IntVector2, Chunk*>::iterator iter;
-	for (iter = m_activeChunks.begin(); iter != m_activeChunks.end(); ++iter)
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
 	{
-		SaveChunkToFile(iter);
+		SaveChunkToFile(m_activeChunks.GetChunk(chunkIndex));
 	}
 }
 
-void World::DeactivateChunk(const ChunkIterator& iter)
+void World::DeactivateChunk(Chunk* chunk)
 {
-	Chunk* chunk = iter->second;
-	
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		Chunk* neighbor = chunk->GetNeighbor((LightingBorder) borderIndex);
+		if (neighbor != nullptr)
+			RecordPendingBorderLight(neighbor, Chunk::GetOppositeBorder((LightingBorder) borderIndex));
+	}
+
 	if (chunk->m_eastNeighbor)
 	{
 		chunk->m_eastNeighbor->m_westNeighbor = nullptr;
@@ -553,67 +1120,130 @@ void World::DeactivateChunk(const ChunkIterator& iter)
 		chunk->m_southNeighbor = nullptr;
 	}
 
-	delete iter->second;
-	m_activeChunks.erase(iter);
+	m_remeshScheduler.RemoveChunk(chunk);
+	ReleaseChunkSlot(chunk);
+	m_activeChunks.Erase(chunk->GetChunkCoords());
+	m_activationFrontier.AddDeactivatedChunk(m_activeChunks, chunk->GetChunkCoords());
+	m_chunkPool.ReleaseChunk(chunk);
 }
 
 void World::ActivateChunk(const IntVector2& chunkCoords)
 {
-	m_activeChunks[chunkCoords] = new Chunk(chunkCoords, m_blockDefinitions);
+	Chunk* chunk = m_chunkPool.AcquireChunk();
+	chunk->Reset(chunkCoords, m_blockDefinitions);
+	if (chunk->m_slotIndex < 0)
+		AssignChunkSlot(chunk);
+	m_lightFlood.FloodChunk(*chunk, m_blockDefinitions);
+	m_activeChunks.Insert(chunkCoords, chunk);
+	m_activationFrontier.AddMissingNeighbors(m_activeChunks, chunkCoords);
+	++m_numChunksGenerated;
 }
 
 void World::SetNeighbors(const IntVector2& chunkCoords)
 {
-// 	Chunk* chunk = m_iterToManipulate->second;
-	Chunk* chunk = m_activeChunks[chunkCoords];
+	Chunk* chunk = m_activeChunks.Find(chunkCoords);
 
-	IntVector2 neighborChunkCoords = chunkCoords;
-	neighborChunkCoords.x++;
-	if (m_activeChunks.find(neighborChunkCoords) != m_activeChunks.end()) 
+	Chunk* neighbor = m_activeChunks.Find(IntVector2(chunkCoords.x + 1, chunkCoords.y));
+	if (neighbor != nullptr)
 	{
-		Chunk* neighbor = m_activeChunks[neighborChunkCoords];
-		if (neighbor != nullptr)
-		{
-			chunk->m_eastNeighbor = neighbor;
-			neighbor->m_westNeighbor = chunk;
-		}
+		chunk->m_eastNeighbor = neighbor;
+		neighbor->m_westNeighbor = chunk;
 	}
 
-	neighborChunkCoords = chunkCoords;
-	neighborChunkCoords.x--;
-	if (m_activeChunks.find(neighborChunkCoords) != m_activeChunks.end())
+	neighbor = m_activeChunks.Find(IntVector2(chunkCoords.x - 1, chunkCoords.y));
+	if (neighbor != nullptr)
 	{
-		Chunk* neighbor = m_activeChunks[neighborChunkCoords];
-		if (neighbor != nullptr)
-		{
-			chunk->m_westNeighbor = neighbor;
-			neighbor->m_eastNeighbor = chunk;
-		}
+		chunk->m_westNeighbor = neighbor;
+		neighbor->m_eastNeighbor = chunk;
 	}
 
-	neighborChunkCoords = chunkCoords;
-	neighborChunkCoords.y++;
-	if (m_activeChunks.find(neighborChunkCoords) != m_activeChunks.end())
+	neighbor = m_activeChunks.Find(IntVector2(chunkCoords.x, chunkCoords.y + 1));
+	if (neighbor != nullptr)
 	{
-		Chunk* neighbor = m_activeChunks[neighborChunkCoords];
-		if (neighbor != nullptr)
-		{
-			chunk->m_northNeighbor = neighbor;
-			neighbor->m_southNeighbor = chunk;
-		}	
+		chunk->m_northNeighbor = neighbor;
+		neighbor->m_southNeighbor = chunk;
 	}
 
-	neighborChunkCoords = chunkCoords;
-	neighborChunkCoords.y--;
-	if (m_activeChunks.find(neighborChunkCoords) != m_activeChunks.end())
+	neighbor = m_activeChunks.Find(IntVector2(chunkCoords.x, chunkCoords.y - 1));
+	if (neighbor != nullptr)
 	{
-		Chunk* neighbor = m_activeChunks[neighborChunkCoords];
-		if (neighbor != nullptr)
-		{
-			chunk->m_southNeighbor = neighbor;
-			neighbor->m_northNeighbor = chunk;
-		}
+		chunk->m_southNeighbor = neighbor;
+		neighbor->m_northNeighbor = chunk;
 	}
+
+	for (int borderIndex = 0; borderIndex < NUM_LIGHTING_BORDERS; ++borderIndex)
+	{
+		if (chunk->GetNeighbor((LightingBorder) borderIndex) != nullptr)
+			ReconcileBorderLight(chunk, (LightingBorder) borderIndex);
+	}
+
+	//the new chunk and any neighbor it completed can now be meshed with correct border faces
+	UpdateChunkState(chunk);
+	if (chunk->m_eastNeighbor != nullptr)
+		UpdateChunkState(chunk->m_eastNeighbor);
+	if (chunk->m_westNeighbor != nullptr)
+		UpdateChunkState(chunk->m_westNeighbor);
+	if (chunk->m_northNeighbor != nullptr)
+		UpdateChunkState(chunk->m_northNeighbor);
+	if (chunk->m_southNeighbor != nullptr)
+		UpdateChunkState(chunk->m_southNeighbor);
+}
+
+int World::CalcNumChunkVertexes() const
+{
+	int numVertexes = 0;
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		numVertexes += m_activeChunks.GetChunk(chunkIndex)->GetNumVertexes();
+	}
+	return numVertexes;
+}
+
+int World::CalcNumChunksAtLOD(ChunkLOD lod) const
+{
+	int numChunks = 0;
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		if (m_activeChunks.GetChunk(chunkIndex)->GetLOD() == lod)
+			++numChunks;
+	}
+	return numChunks;
+}
+
+int World::CalcNumChunkIndexes() const
+{
+	int numIndexes = 0;
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		numIndexes += m_activeChunks.GetChunk(chunkIndex)->GetNumIndexes();
+	}
+	return numIndexes;
+}
+
+int World::CalcNumMeshQueueGrowths()
+{
+	std::lock_guard< std::mutex > lock(m_completedMeshesMutex);
+	return m_meshWorkers->GetNumJobQueueGrowths() + m_completedMeshes.GetNumGrowths();
+}
+
+int World::CalcNumChunkPackedVertexBytes() const
+{
+	int numBytes = 0;
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		numBytes += m_activeChunks.GetChunk(chunkIndex)->CalcNumPackedVertexBytes();
+	}
+	return numBytes;
+}
+
+int World::CalcNumChunkVBOBytes() const
+{
+	int numBytes = 0;
+	for (int chunkIndex = 0; chunkIndex < m_activeChunks.GetSize(); ++chunkIndex)
+	{
+		numBytes += m_activeChunks.GetChunk(chunkIndex)->CalcNumVBOBytes();
+	}
+	return numBytes;
 }
 
 float World::CalcPlayerDistanceToChunk(Vector3& playerPosition, const Vector3& chunkPos)
@@ -623,74 +1253,174 @@ float World::CalcPlayerDistanceToChunk(Vector3& playerPosition, const Vector3& c
 
 void World::PlaceBlockAtFarthestOpaqueBlock(BlockInfo& farthestOpaqueBlockFromPlayer, unsigned char blockType)
 {
-	farthestOpaqueBlockFromPlayer.m_chunk->m_blocks[farthestOpaqueBlockFromPlayer.m_blockIndex] = Block(blockType, m_blockDefinitions[blockType]->IsOpaque(), m_blockDefinitions[blockType]->IsSolid() );
-	farthestOpaqueBlockFromPlayer.m_chunk->m_blocks[farthestOpaqueBlockFromPlayer.m_blockIndex].SetIsLightingDirty(true);
-	farthestOpaqueBlockFromPlayer.m_chunk->m_blocks[farthestOpaqueBlockFromPlayer.m_blockIndex].SetLightLevel(0);
-	farthestOpaqueBlockFromPlayer.m_chunk->m_blocks[farthestOpaqueBlockFromPlayer.m_blockIndex].SetIsSky(false);
-	m_dirtyLightingBlocks.push_back( new BlockInfo(farthestOpaqueBlockFromPlayer));
-	SetColumnIsNotSky(farthestOpaqueBlockFromPlayer);
+	double startSeconds = GetCurrentTimeSeconds();
+	m_isRelightingEdit = true;
+	//the new block starts without the queued flag, so a pending lighting entry for the old one no longer counts
+	Block& block = farthestOpaqueBlockFromPlayer.m_chunk->m_blocks[farthestOpaqueBlockFromPlayer.m_blockIndex];
+	if (block.GetIsLightingDirty())
+		--farthestOpaqueBlockFromPlayer.m_chunk->m_numDirtyLightingBlocks;
+	int skyLightLevel = block.GetSkyLightLevel();
+	int lightLevel = block.GetLightLevel();
+	block = Block(blockType, m_blockDefinitions[blockType]->IsOpaque(), m_blockDefinitions[blockType]->IsSolid() );
+	block.SetSkyLightLevel(skyLightLevel);
+	block.SetLightLevel(lightLevel);
+	RemoveBlockLight(farthestOpaqueBlockFromPlayer, true, true);
+	RaiseSkyHeightForPlacedBlock(farthestOpaqueBlockFromPlayer);
+	farthestOpaqueBlockFromPlayer.m_chunk->UpdateSectionFlags(Chunk::GetSectionIndexForBlockIndex(farthestOpaqueBlockFromPlayer.m_blockIndex));
+	SetBlockMeshDirty(farthestOpaqueBlockFromPlayer);
+	RelightAndRemeshEdit(farthestOpaqueBlockFromPlayer, startSeconds);
 }
 
 void World::RemoveBlockAtClosestNonOpaqueBlock(BlockInfo& closestOpaqueBlockToPlayer)
 {
+	double startSeconds = GetCurrentTimeSeconds();
+	m_isRelightingEdit = true;
 // 	Block* block = closestOpaqueBlockToPlayer.GetBlock();
 	// closestOpaqueBlockToPlayer.m_chunk->m_blocks[closestOpaqueBlockToPlayer.m_blockIndex] = Block();
 	closestOpaqueBlockToPlayer.m_chunk->m_blocks[closestOpaqueBlockToPlayer.m_blockIndex].SetBlockType(BLOCK_TYPE_AIR);
 	closestOpaqueBlockToPlayer.m_chunk->m_blocks[closestOpaqueBlockToPlayer.m_blockIndex].SetIsOpaque(false);
 	closestOpaqueBlockToPlayer.m_chunk->m_blocks[closestOpaqueBlockToPlayer.m_blockIndex].SetIsSolid(false);//#FIXME: don't make a new block, change the block
-	closestOpaqueBlockToPlayer.m_chunk->m_blocks[closestOpaqueBlockToPlayer.m_blockIndex].SetIsLightingDirty(true); //make this a combined function with the line below
-	m_dirtyLightingBlocks.push_back( new BlockInfo(closestOpaqueBlockToPlayer) );
-	SetColumnIsSky(closestOpaqueBlockToPlayer);
+	RemoveBlockLight(closestOpaqueBlockToPlayer, true, true);
+	LowerSkyHeightForRemovedBlock(closestOpaqueBlockToPlayer);
+	closestOpaqueBlockToPlayer.m_chunk->UpdateSectionFlags(Chunk::GetSectionIndexForBlockIndex(closestOpaqueBlockToPlayer.m_blockIndex));
+	SetBlockMeshDirty(closestOpaqueBlockToPlayer);
+	RelightAndRemeshEdit(closestOpaqueBlockToPlayer, startSeconds);
 }
 
-void World::SetColumnIsNotSky(const BlockInfo& topBlockInfoOfColumn)
+void World::RelightAndRemeshEdit(const BlockInfo& editedBlockInfo, double startSeconds)
 {
-	IntVector3 blockCoords = topBlockInfoOfColumn.m_chunk->GetBlockCoordsForBlockIndex(topBlockInfoOfColumn.m_blockIndex);
-	for (int columnIndexZ = blockCoords.z - 1; columnIndexZ >= 0; --columnIndexZ)
+	//light around an edit is settled on this thread, anything past the budget goes back to the background queue
+	UpdateLightRemoval();
+	int numBlocksRelit = 0;
+	while (!m_editLightingBlocks.IsEmpty() && numBlocksRelit < EDIT_RELIGHT_MAX_BLOCKS)
 	{
-		int blockIndex = topBlockInfoOfColumn.m_chunk->GetBlockIndexForBlockCoords(IntVector3(blockCoords.x, blockCoords.y, columnIndexZ));
+		UpdateBlockLighting(m_editLightingBlocks.PopFront());
+		++numBlocksRelit;
+	}
+	m_isRelightingEdit = false;
+	while (!m_editLightingBlocks.IsEmpty())
+	{
+		m_dirtyLightingBlocks.PushBack(m_editLightingBlocks.PopFront());
+	}
 
-		if (!topBlockInfoOfColumn.m_chunk->m_blocks[blockIndex].GetIsOpaque())
-		{
-			topBlockInfoOfColumn.m_chunk->m_blocks[blockIndex].SetIsSky(false);
-			topBlockInfoOfColumn.m_chunk->m_blocks[blockIndex].SetLightLevel(0);
-			topBlockInfoOfColumn.m_chunk->m_blocks[blockIndex].SetIsLightingDirty(true);
-			m_dirtyLightingBlocks.push_back( new BlockInfo(topBlockInfoOfColumn.m_chunk, blockIndex) );
-		}
-		else
-		{
-			break;	
-		}
+	//only the dirty sections of the edited chunk and the neighbors sharing the block's border are remeshed
+	Chunk* chunk = editedBlockInfo.m_chunk;
+	RemeshChunkNow(chunk);
+	IntVector3 blockCoords = Chunk::GetBlockCoordsForBlockIndex(editedBlockInfo.m_blockIndex);
+	if (blockCoords.x == 0 && chunk->m_westNeighbor != nullptr)
+		RemeshChunkNow(chunk->m_westNeighbor);
+	if (blockCoords.x == CHUNK_BLOCKS_WIDE_X - 1 && chunk->m_eastNeighbor != nullptr)
+		RemeshChunkNow(chunk->m_eastNeighbor);
+	if (blockCoords.y == 0 && chunk->m_southNeighbor != nullptr)
+		RemeshChunkNow(chunk->m_southNeighbor);
+	if (blockCoords.y == CHUNK_BLOCKS_DEEP_Y - 1 && chunk->m_northNeighbor != nullptr)
+		RemeshChunkNow(chunk->m_northNeighbor);
+
+	m_lastEditNumBlocksRelit = numBlocksRelit;
+	m_lastEditMilliseconds = (float) ((GetCurrentTimeSeconds() - startSeconds) * 1000.0);
+}
+
+void World::SetBlockLightDirty(const BlockInfo& blockInfo)
+{
+	//blocks on a chunk edge also light the border faces of the neighbor chunk
+	blockInfo.m_chunk->SetBlockLightIsDirty(blockInfo.m_blockIndex);
+	QueueChunkForRemesh(blockInfo.m_chunk);
+
+	IntVector3 blockCoords = Chunk::GetBlockCoordsForBlockIndex(blockInfo.m_blockIndex);
+	if (blockCoords.x == 0 && blockInfo.m_chunk->m_westNeighbor != nullptr)
+	{
+		blockInfo.m_chunk->m_westNeighbor->SetBlockLightIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_westNeighbor);
+	}
+	if (blockCoords.x == CHUNK_BLOCKS_WIDE_X - 1 && blockInfo.m_chunk->m_eastNeighbor != nullptr)
+	{
+		blockInfo.m_chunk->m_eastNeighbor->SetBlockLightIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_eastNeighbor);
+	}
+	if (blockCoords.y == 0 && blockInfo.m_chunk->m_southNeighbor != nullptr)
+	{
+		blockInfo.m_chunk->m_southNeighbor->SetBlockLightIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_southNeighbor);
+	}
+	if (blockCoords.y == CHUNK_BLOCKS_DEEP_Y - 1 && blockInfo.m_chunk->m_northNeighbor != nullptr)
+	{
+		blockInfo.m_chunk->m_northNeighbor->SetBlockLightIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_northNeighbor);
 	}
 }
 
-void World::SetColumnIsSky(const BlockInfo& blockInfoInColumn)
+void World::SetBlockMeshDirty(const BlockInfo& blockInfo)
 {
-	IntVector3 blockCoords = blockInfoInColumn.m_chunk->GetBlockCoordsForBlockIndex(blockInfoInColumn.m_blockIndex);
+	//blocks on a chunk edge also show up in the border faces of the neighbor chunk
+	blockInfo.m_chunk->SetBlockIsDirty(blockInfo.m_blockIndex);
+	QueueChunkForRemesh(blockInfo.m_chunk);
 
-	for (int columnIndexZ = CHUNK_BLOCKS_TALL_Z - 1; columnIndexZ >= 0; --columnIndexZ)
+	IntVector3 blockCoords = Chunk::GetBlockCoordsForBlockIndex(blockInfo.m_blockIndex);
+	if (blockCoords.x == 0 && blockInfo.m_chunk->m_westNeighbor != nullptr)
+	{
+		blockInfo.m_chunk->m_westNeighbor->SetBlockIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_westNeighbor);
+	}
+	if (blockCoords.x == CHUNK_BLOCKS_WIDE_X - 1 && blockInfo.m_chunk->m_eastNeighbor != nullptr)
+	{
+		blockInfo.m_chunk->m_eastNeighbor->SetBlockIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_eastNeighbor);
+	}
+	if (blockCoords.y == 0 && blockInfo.m_chunk->m_southNeighbor != nullptr)
 	{
-		int blockIndex = blockInfoInColumn.m_chunk->GetBlockIndexForBlockCoords( IntVector3(blockCoords.x, blockCoords.y, columnIndexZ) );
+		blockInfo.m_chunk->m_southNeighbor->SetBlockIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_southNeighbor);
+	}
+	if (blockCoords.y == CHUNK_BLOCKS_DEEP_Y - 1 && blockInfo.m_chunk->m_northNeighbor != nullptr)
+	{
+		blockInfo.m_chunk->m_northNeighbor->SetBlockIsDirty(blockInfo.m_blockIndex);
+		QueueChunkForRemesh(blockInfo.m_chunk->m_northNeighbor);
+	}
+}
 
-		if (!blockInfoInColumn.m_chunk->m_blocks[blockIndex].GetIsOpaque())
-		{
-			blockInfoInColumn.m_chunk->m_blocks[blockIndex].SetIsSky(true);
-			blockInfoInColumn.m_chunk->m_blocks[blockIndex].SetIsLightingDirty(true);
-			blockInfoInColumn.m_chunk->m_blocks[blockIndex].SetLightLevel(0);
-			m_dirtyLightingBlocks.push_back( new BlockInfo(blockInfoInColumn.m_chunk, blockIndex) );
-		}
-		else
-		{
-			break;
-		}
+void World::RaiseSkyHeightForPlacedBlock(const BlockInfo& placedBlockInfo)
+{
+	//only an opaque block above the old height shades anything, and only the blocks it now covers
+	Chunk* chunk = placedBlockInfo.m_chunk;
+	int columnIndex = Chunk::GetColumnIndexForBlockIndex(placedBlockInfo.m_blockIndex);
+	int skyHeight = chunk->GetSkyHeight(columnIndex);
+	int placedBlockZ = placedBlockInfo.m_blockIndex >> CHUNK_BITS_XY;
+	if (!chunk->m_blocks[placedBlockInfo.m_blockIndex].GetIsOpaque() || placedBlockZ < skyHeight)
+		return;
+
+	chunk->SetSkyHeight(columnIndex, placedBlockZ + 1);
+	for (int blockIndexZ = placedBlockZ - 1; blockIndexZ >= skyHeight; --blockIndexZ)
+	{
+		//sky light is removed like any other light
+		RemoveBlockLight(BlockInfo(chunk, columnIndex + (blockIndexZ * CHUNK_BLOCKS_PER_LAYER)), true, false);
+	}
+}
+
+void World::LowerSkyHeightForRemovedBlock(const BlockInfo& removedBlockInfo)
+{
+	//only removing the top opaque block opens the column, down to the next opaque block
+	Chunk* chunk = removedBlockInfo.m_chunk;
+	int columnIndex = Chunk::GetColumnIndexForBlockIndex(removedBlockInfo.m_blockIndex);
+	int removedBlockZ = removedBlockInfo.m_blockIndex >> CHUNK_BITS_XY;
+	if (removedBlockZ + 1 != chunk->GetSkyHeight(columnIndex))
+		return;
+
+	int skyHeight = removedBlockZ;
+	while (skyHeight > 0 && !chunk->m_blocks[columnIndex + ((skyHeight - 1) * CHUNK_BLOCKS_PER_LAYER)].GetIsOpaque())
+	{
+		--skyHeight;
+	}
+	chunk->SetSkyHeight(columnIndex, skyHeight);
+	for (int blockIndexZ = removedBlockZ; blockIndexZ >= skyHeight; --blockIndexZ)
+	{
+		AddDirtyLightingBlock(chunk, columnIndex + (blockIndexZ * CHUNK_BLOCKS_PER_LAYER));
 	}
 }
 
 void World::SetFarthestEastBlock(const Vector3& playerPos)
 {
-	Chunk* chunkAtPlayerPos = m_activeChunks[ IntVector2( (int) playerPos.x, (int) playerPos.y ) ];
-	
-	
+	BlockInfo playerBlockInfo;
+	Chunk* chunkAtPlayerPos = m_activeChunks.Find(playerBlockInfo.GetChunkCoordsFromWorldPos(playerPos));
 	while (chunkAtPlayerPos != nullptr)
 	{
 		m_farthestEastChunk = chunkAtPlayerPos;
@@ -723,89 +1453,126 @@ char World::GetSkyLightLevelForChunkCoords(const IntVector2& chunkCoords)
 
 void World::CalcOutdoorLightLevel()
 {
-	unsigned char originalLightLevel = m_outdoorLightLevel;
+	//sky light is unscaled in the blocks and meshes, the chunk tile shader scales it when drawing
 	m_outdoorLightLevel = (unsigned char) Clamp( (sin( (m_timeOfDay * DAY_LENGTH_DIVISOR) * fPI ) * (m_dayMaxLightLevel - m_nightMinLightLevel) ) + m_nightMinLightLevel, m_nightMinLightLevel, m_dayMaxLightLevel);
-	if (m_outdoorLightLevel != originalLightLevel)
-	{
-		m_farthestEastChunk->m_blocks[NUM_BLOCKS_PER_CHUNK - 1].SetIsLightingDirty(true);
-		m_farthestEastChunk->m_blocks[NUM_BLOCKS_PER_CHUNK - 1].SetLightLevel(0);
-		m_dirtyLightingBlocks.push_back( new BlockInfo(m_farthestEastChunk, NUM_BLOCKS_PER_CHUNK - 1));
-	}
 }
 
-Vector3 World::CalcEastNeighborCenterWorldCoords(const IntVector2& chunkCoords)
+Vector3 World::CalcChunkCenterWorldCoords(const IntVector2& chunkCoords)
 {
-	return Vector3( ( (chunkCoords.x + 1) * CHUNK_BLOCKS_WIDE_X) + (CHUNK_BLOCKS_WIDE_X * 0.5f), (chunkCoords.y * CHUNK_BLOCKS_DEEP_Y) + (CHUNK_BLOCKS_DEEP_Y * 0.5f), CHUNK_BLOCKS_TALL_Z * 0.5f );
+	return Vector3( (chunkCoords.x * CHUNK_BLOCKS_WIDE_X) + (CHUNK_BLOCKS_WIDE_X * 0.5f), (chunkCoords.y * CHUNK_BLOCKS_DEEP_Y) + (CHUNK_BLOCKS_DEEP_Y * 0.5f), CHUNK_BLOCKS_TALL_Z * 0.5f );
 }
 
-Vector3 World::CalcWestNeighborCenterWorldCoords(const IntVector2& chunkCoords)
+void World::AddDirtyLightingBlock(Chunk* chunk, int blockIndex)
 {
-	return Vector3( ( (chunkCoords.x - 1) * CHUNK_BLOCKS_WIDE_X) + (CHUNK_BLOCKS_WIDE_X * 0.5f), (chunkCoords.y * CHUNK_BLOCKS_DEEP_Y) + (CHUNK_BLOCKS_DEEP_Y * 0.5f), CHUNK_BLOCKS_TALL_Z * 0.5f );
+	//the lighting dirty flag marks a block as queued so it is only ever in the queue once
+	Block& block = chunk->m_blocks[blockIndex];
+	if (block.GetIsLightingDirty())
+		return;
+	block.SetIsLightingDirty(true);
+	++chunk->m_numDirtyLightingBlocks;
+
+	if (chunk->m_slotIndex < 0)
+		AssignChunkSlot(chunk);
+	unsigned int lightingEntry = LightingQueue::PackEntry(chunk->m_slotIndex, blockIndex);
+	if (m_isRelightingEdit)
+		m_editLightingBlocks.PushBack(lightingEntry);
+	else
+		m_dirtyLightingBlocks.PushBack(lightingEntry);
 }
 
-Vector3 World::CalcNorthNeighborCenterWorldCoords(const IntVector2& chunkCoords)
+void World::RecordPendingBorderLight(Chunk* chunk, LightingBorder border)
 {
-	return Vector3( ( (chunkCoords.x) * CHUNK_BLOCKS_WIDE_X) + (CHUNK_BLOCKS_WIDE_X * 0.5f), ( (chunkCoords.y + 1) * CHUNK_BLOCKS_DEEP_Y) + (CHUNK_BLOCKS_DEEP_Y * 0.5f), CHUNK_BLOCKS_TALL_Z * 0.5f );
+	//light the unloading neighbor gave this chunk stays until a chunk links there again and shows what changed
+	chunk->GetNeighbor(border)->CopyBorderLight(Chunk::GetOppositeBorder(border), chunk->m_pendingBorderLight[border]);
 }
 
-Vector3 World::CalcSouthNeighborCenterWorldCoords(const IntVector2& chunkCoords)
+void World::ReconcileBorderLight(Chunk* chunk, LightingBorder border)
 {
-	return Vector3( ( (chunkCoords.x) * CHUNK_BLOCKS_WIDE_X) + (CHUNK_BLOCKS_WIDE_X * 0.5f), ( (chunkCoords.y - 1) * CHUNK_BLOCKS_DEEP_Y) + (CHUNK_BLOCKS_DEEP_Y * 0.5f), CHUNK_BLOCKS_TALL_Z * 0.5f );
+	//both chunks were lit without each other, so only the blocks on the shared face are checked in each direction
+	Chunk* neighbor = chunk->GetNeighbor(border);
+	LightingBorder neighborBorder = Chunk::GetOppositeBorder(border);
+	for (int borderIndex = 0; borderIndex < LIGHTING_BORDER_SIZE; ++borderIndex)
+	{
+		int blockIndex = Chunk::GetBlockIndexForBorderIndex(border, borderIndex);
+		int neighborBlockIndex = Chunk::GetBlockIndexForBorderIndex(neighborBorder, borderIndex);
+		ReconcileBorderBlock(chunk, blockIndex, neighbor->m_blocks[neighborBlockIndex].GetPackedLight(), border, borderIndex);
+		ReconcileBorderBlock(neighbor, neighborBlockIndex, chunk->m_blocks[blockIndex].GetPackedLight(), neighborBorder, borderIndex);
+	}
+	chunk->m_pendingBorderLight[border].clear();
+	neighbor->m_pendingBorderLight[neighborBorder].clear();
 }
 
-void World::SetBlockNeighborsDirty(BlockInfo* blockInfo)
+void World::ReconcileBorderBlock(Chunk* chunk, int blockIndex, int neighborPackedLight, LightingBorder border, int borderIndex)
 {
-	BlockInfo* neighborAbove = new BlockInfo(blockInfo->GetAboveNeighbor());
-	if (neighborAbove->m_chunk != nullptr)
-	{
-		neighborAbove->GetBlock()->SetIsLightingDirty(true);
-		m_dirtyLightingBlocks.push_back(neighborAbove);
-	}
-// 	delete neighborAbove;
-// 	neighborAbove = nullptr;
+	const Block& block = chunk->m_blocks[blockIndex];
+	if (block.GetIsOpaque())
+		return;
 
-	BlockInfo* neighborBelow = new BlockInfo(blockInfo->GetBelowNeighbor());
-	if (neighborBelow->m_chunk != nullptr)
+	//a channel the old neighbor had brighter may have lit this side, so it is removed as if that neighbor block went dark
+	int neighborSkyLightLevel = Block::GetSkyLightLevelForPackedLight(neighborPackedLight);
+	int neighborLightLevel = Block::GetLightLevelForPackedLight(neighborPackedLight);
+	const std::vector< unsigned char >& pendingBorderLight = chunk->m_pendingBorderLight[border];
+	if (!pendingBorderLight.empty())
 	{
-		neighborBelow->GetBlock()->SetIsLightingDirty(true);
-		m_dirtyLightingBlocks.push_back(neighborBelow);
+		int pendingSkyLightLevel = Block::GetSkyLightLevelForPackedLight(pendingBorderLight[borderIndex]);
+		int pendingLightLevel = Block::GetLightLevelForPackedLight(pendingBorderLight[borderIndex]);
+		int removedSkyLightLevel = neighborSkyLightLevel < pendingSkyLightLevel ? pendingSkyLightLevel : 0;
+		int removedLightLevel = neighborLightLevel < pendingLightLevel ? pendingLightLevel : 0;
+		if (removedSkyLightLevel > 0 || removedLightLevel > 0)
+			RemoveNeighborLight(BlockInfo(chunk, blockIndex), Block::PackLight(removedSkyLightLevel, removedLightLevel));
 	}
-// 	delete neighborBelow;
-// 	neighborBelow = nullptr;
 
-	BlockInfo* neighborEast = new BlockInfo(blockInfo->GetEastNeighbor());
-	if (neighborEast->m_chunk != nullptr)
-	{
-		neighborEast->GetBlock()->SetIsLightingDirty(true);
-		m_dirtyLightingBlocks.push_back(neighborEast);
-	}
-// 	delete neighborEast;
-// 	neighborEast = nullptr;
+	if (neighborSkyLightLevel - 1 > block.GetSkyLightLevel() || neighborLightLevel - 1 > block.GetLightLevel())
+		AddDirtyLightingBlock(chunk, blockIndex);
+}
 
-	BlockInfo* neighborWest = new BlockInfo(blockInfo->GetWestNeighbor());
-	if (neighborWest->m_chunk != nullptr)
+void World::AssignChunkSlot(Chunk* chunk)
+{
+	if (m_freeChunkSlots.empty())
 	{
-		neighborWest->GetBlock()->SetIsLightingDirty(true);
-		m_dirtyLightingBlocks.push_back(neighborWest);
+		chunk->m_slotIndex = (int) m_chunkSlots.size();
+		m_chunkSlots.push_back(chunk);
+		return;
 	}
-// 	delete neighborWest;
-// 	neighborWest = nullptr;
 
-	BlockInfo* neighborNorth = new BlockInfo(blockInfo->GetNorthNeighbor());
-	if (neighborNorth->m_chunk != nullptr)
-	{
-		neighborNorth->GetBlock()->SetIsLightingDirty(true);
-		m_dirtyLightingBlocks.push_back(neighborNorth);
-	}
-// 	delete neighborNorth;
-// 	neighborNorth = nullptr;
+	chunk->m_slotIndex = m_freeChunkSlots.back();
+	m_freeChunkSlots.pop_back();
+	m_chunkSlots[chunk->m_slotIndex] = chunk;
+}
 
-	BlockInfo* neighborSouth = new BlockInfo(blockInfo->GetSouthNeighbor());
-	if (neighborSouth->m_chunk != nullptr)
-	{
-		neighborSouth->GetBlock()->SetIsLightingDirty(true);
-		m_dirtyLightingBlocks.push_back(neighborSouth);
-	}
-// 	delete neighborSouth;
-// 	neighborSouth = nullptr;
+void World::ReleaseChunkSlot(Chunk* chunk)
+{
+	if (chunk->m_slotIndex < 0)
+		return;
+
+	m_chunkSlots[chunk->m_slotIndex] = nullptr;
+	m_freeChunkSlots.push_back(chunk->m_slotIndex);
+	chunk->m_slotIndex = -1;
+}
+
+void World::SetBlockNeighborsDirty(BlockInfo* blockInfo)
+{
+	BlockInfo neighbor = blockInfo->GetAboveNeighbor();
+	if (neighbor.m_chunk != nullptr)
+		AddDirtyLightingBlock(neighbor.m_chunk, neighbor.m_blockIndex);
+
+	neighbor = blockInfo->GetBelowNeighbor();
+	if (neighbor.m_chunk != nullptr)
+		AddDirtyLightingBlock(neighbor.m_chunk, neighbor.m_blockIndex);
+
+	neighbor = blockInfo->GetEastNeighbor();
+	if (neighbor.m_chunk != nullptr)
+		AddDirtyLightingBlock(neighbor.m_chunk, neighbor.m_blockIndex);
+
+	neighbor = blockInfo->GetWestNeighbor();
+	if (neighbor.m_chunk != nullptr)
+		AddDirtyLightingBlock(neighbor.m_chunk, neighbor.m_blockIndex);
+
+	neighbor = blockInfo->GetNorthNeighbor();
+	if (neighbor.m_chunk != nullptr)
+		AddDirtyLightingBlock(neighbor.m_chunk, neighbor.m_blockIndex);
+
+	neighbor = blockInfo->GetSouthNeighbor();
+	if (neighbor.m_chunk != nullptr)
+		AddDirtyLightingBlock(neighbor.m_chunk, neighbor.m_blockIndex);
 }
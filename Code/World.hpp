@@ -3,29 +3,90 @@
 #include "Engine/Renderer/SpriteSheet.hpp"
 #include "Game/Chunk.hpp"
 #include "BlockInfo.hpp"
-#include <map>
-#include <deque>
-
-typedef std::map<IntVector2, Chunk*>::iterator ChunkIterator;
+#include "Game/ChunkMeshBuilder.hpp"
+#include "Game/WorkerThreadPool.hpp"
+#include "Game/ChunkMeshArena.hpp"
+#include "Game/ChunkRemeshScheduler.hpp"
+#include "Game/ChunkMeshCache.hpp"
+#include "Game/LightingQueue.hpp"
+#include "Game/LightingSolver.hpp"
+#include "Game/ChunkLightFlood.hpp"
+#include "Game/ActiveChunkMap.hpp"
+#include "Game/ChunkActivationFrontier.hpp"
+#include "Game/ChunkPool.hpp"
+#include "Game/ChunkTileShader.hpp"
+#include <mutex>
 
 const float DAY_LENGTH = 1000.f;
 const float DAY_LENGTH_DIVISOR = 1.f / DAY_LENGTH;
+const int MESH_UPLOAD_BYTES_PER_FRAME = 4 * 1024 * 1024;
+const int MESH_JOBS_IN_FLIGHT_PER_WORKER = 4;
+const int COMPLETED_MESHES_INITIAL_CAPACITY = 64;
+const int MESH_BENCHMARK_RUNS_PER_CHUNK = 4;
+const int LIGHTING_CHECK_NUM_EDITS = 64;
+const float LIGHTING_SOLVER_CHECK_RANGE = 64.f; //chunks this close to the player are relit by the solver check
+const float LIGHTING_SECONDS_PER_FRAME = 0.004f; //main thread time for lighting rounds, the workers add to it
+const int EDIT_RELIGHT_MAX_BLOCKS = 16384; //lighting updates done right away for a placed or removed block
+const int CHUNK_ACTIVATIONS_PER_FRAME = 4; //closest missing chunks generated or loaded each frame
+const int CHUNK_DEACTIVATIONS_PER_FRAME = 4;
+const int CHUNK_POOL_CAPACITY = 512; //room for the minimum number of active chunks, activation waits while the pool is full
+const bool CHUNK_POOL_USES_LARGE_PAGES = true; //falls back to normal pages when the account may not lock memory
+const float REMESH_SECONDS_PER_FRAME = 0.002f; //main thread time for snapshotting and recoloring queued chunks
+
+struct ChunkDeactivationCandidate
+{
+	Chunk* m_chunk;
+	float m_distance; //to the player
+};
 
 class World
 {
 public:
-	std::map< IntVector2, Chunk* > m_activeChunks;
-	std::deque<BlockInfo*> m_dirtyLightingBlocks;
+	ActiveChunkMap m_activeChunks;
+	LightingQueue m_dirtyLightingBlocks;
+	LightingQueue m_editLightingBlocks; //lighting caused by the current block edit
+	LightingQueue m_lightRemovalBlocks; //pairs of a packed entry and the packed sky and block light the block lost
+	std::vector< Chunk* > m_chunkSlots; //lighting entries refer to chunks by slot, nullptr once deactivated
+	std::vector< int > m_freeChunkSlots;
+	RingBuffer< ChunkMeshResult* > m_completedMeshes;
+	std::mutex m_completedMeshesMutex;
+	WorkerThreadPool* m_meshWorkers; //also runs the lighting jobs
+	LightingSolver* m_lightingSolver;
+	ChunkLightFlood m_lightFlood; //lights new chunks on their own, their borders are reconciled when they link
+	ChunkMeshArena m_meshArena;
+	ChunkRemeshScheduler m_remeshScheduler;
+	ChunkPool m_chunkPool; //storage of every active chunk, deactivated chunks go back to it
+	ChunkMeshCache m_meshCache;
+	ChunkTileShader m_tileShader; //draws every chunk section from its packed vertexes
 	BlockDefinition* m_blockDefinitions[BLOCK_TYPE_SIZE];
-	ChunkIterator m_iterToManipulate;
+	ChunkActivationFrontier m_activationFrontier;
+	std::vector< ChunkDeactivationCandidate > m_deactivationCandidates; //kept between frames so it is not reallocated
 	SpriteSheet* m_tileSheet;
 	Chunk* m_farthestEastChunk;
-	float m_distanceToIterToManipulate;
-	float m_distanceToPlayer;
 	float m_timeOfDay;
 	int m_maxNumChunks;
 	int m_minNumChunks;
 	int m_minRangeOfActiveChunks;
+	int m_nextMeshJobID;
+	int m_numMeshJobsInFlight;
+	int m_numChunksGenerated; //generated or loaded since the streaming counters were reset
+	int m_numChunkMeshJobs;
+	bool m_isRelightingEdit;
+	int m_lastEditNumBlocksRelit;
+	float m_lastEditMilliseconds; //relight and remesh time of the last block edit
+	float m_lightingBlocksPerMillisecond; //throughput of the last frame that had lighting work
+	float m_meshBenchmarkBlockMilliseconds; //average per chunk, 0 until the benchmark is run
+	float m_meshBenchmarkMaskMilliseconds;
+	int m_lightingCheckNumEdits; //0 until the lighting check is run
+	int m_lightingCheckNumMismatches; //blocks that differ from the full recompute, after the edits and after undoing them
+	float m_lightingCheckRelightMilliseconds; //incremental relight of the edits and their undo
+	float m_lightingCheckRecomputeMilliseconds; //one full recompute of every active chunk
+	int m_solverCheckNumChunks; //0 until the solver check is run
+	int m_solverCheckNumMismatches; //blocks whose parallel light differs from the serial light
+	int m_solverCheckNumEditMismatches; //blocks whose serial solver light differs from relighting them one at a time like an edit
+	int m_solverCheckNumHelperJoins;
+	float m_solverCheckSerialMilliseconds;
+	float m_solverCheckParallelMilliseconds;
 	char m_fileVersionNumber;
 	char m_outdoorLightLevel;
 	char m_dayMaxLightLevel;
@@ -39,31 +100,78 @@ public:
 
 	void Update(float deltaSeconds, Vector3& playerPos, const Vector3& cameraForwardXYZ, const Vector3& cameraPos);
 	void UpdateChunks(Vector3& playerPos, const Vector3& cameraForwardXYZ, const Vector3& cameraPos);
+	int DeactivateFarthestChunks(int maxNumChunks);
+	int ActivateClosestChunks(Vector3& playerPos);
 	void UpdateTimeOfDay(float deltaSeconds);
 	void UpdateLighting();
-	void UpdateVertexArrays();
+	int UpdateLightingRound();
+	void ApplyLightingJob(ChunkLightingJob& job);
+	void UpdateLightRemoval();
+	void RemoveNeighborLight(const BlockInfo& neighbor, int removedPackedLight);
+	void RemoveBlockLight(const BlockInfo& blockInfo, bool isRemovingSkyLight, bool isRemovingLight);
+	void UpdateBlockLighting(unsigned int lightingEntry);
+	void AddNeighborPackedLight(const BlockInfo& neighbor, int neighborPackedLights[], int& numNeighbors);
+	void UpdateVertexArrays(const Vector3& cameraPos);
+	void ScheduleRemeshes(const Vector3& cameraPos, int maxBytesToUpload);
+	void QueueChunkForRemesh(Chunk* chunk);
+	void UpdateChunkState(Chunk* chunk);
+	void QueueChunkMeshJob(Chunk* chunk);
+	void CreateChunkMeshJob(Chunk* chunk, ChunkMeshInput*& meshInput, ChunkMeshResult*& meshResult);
+	bool ApplyCachedChunkMesh(Chunk* chunk, ChunkMeshInput* meshInput, ChunkMeshResult* meshResult);
+	static void RunChunkMeshJob(void* jobOwner, void* jobInput, void* jobOutput);
+	void BuildChunkMesh(ChunkMeshInput* meshInput, ChunkMeshResult* meshResult);
+	int UploadCompletedMeshes();
+	int ApplyChunkMeshResult(Chunk* chunk, ChunkMeshResult& meshResult);
+	void RemeshChunkNow(Chunk* chunk);
+	bool CanQueueChunkMeshJob() const;
+	void SetAllChunksDirty();
+	void RunMeshBenchmark();
+	void RunLightingCheck();
+	bool EditRandomBlockForLightingCheck(BlockInfo& editedBlockInfo, unsigned char& originalBlockType);
+	void SettleLighting();
+	int CountLightingMismatches();
+	void RecomputeLightLevels(std::vector< std::vector< unsigned char > >& lightLevels, bool isSkyLight) const;
+	void RunLightingSolverCheck(Vector3& playerPos);
+	double RelightChunksFromScratch(const std::vector< Chunk* >& chunks, bool isRelightingEdit);
+	void CopyChunkPackedLights(const std::vector< Chunk* >& chunks, std::vector< int >& packedLights) const;
+	int CountPackedLightMismatches(const std::vector< Chunk* >& chunks, const std::vector< int >& packedLights) const;
+	void ResetStreamingCounters();
+	float CalcMeshesPerChunk() const;
 
 	void Render() const;
 	void RenderAxes(float lineThickness, float alphaAmount) const;
 
-	void SaveChunkToFile(const ChunkIterator& iter);
+	void SaveChunkToFile(Chunk* chunk);
 	bool LoadChunkFromFile(IntVector2 chunkCoords);
 	void SaveAllChunks();
-	void DeactivateChunk(const ChunkIterator& iter);
+	void DeactivateChunk(Chunk* chunk);
 	void ActivateChunk(const IntVector2& chunkCoords);
 	void SetNeighbors(const IntVector2& chunkCoords);
+	int CalcNumChunkVertexes() const;
+	int CalcNumChunkIndexes() const;
+	int CalcNumChunkPackedVertexBytes() const;
+	int CalcNumChunkVBOBytes() const;
+	int CalcNumMeshQueueGrowths();
+	int CalcNumChunksAtLOD(ChunkLOD lod) const;
 	float CalcPlayerDistanceToChunk(Vector3& playerPosition, const Vector3& chunkPos);
 	void PlaceBlockAtFarthestOpaqueBlock(BlockInfo& farthestOpaqueBlockFromPlayer, unsigned char blockType);
 	void RemoveBlockAtClosestNonOpaqueBlock(BlockInfo& closestOpaqueBlockToPlayer);
-	void SetColumnIsNotSky(const BlockInfo& topBlockInfoOfColumn);
-	void SetColumnIsSky(const BlockInfo& blockInfoInColumn);
+	void RelightAndRemeshEdit(const BlockInfo& editedBlockInfo, double startSeconds);
+	void RaiseSkyHeightForPlacedBlock(const BlockInfo& placedBlockInfo);
+	void LowerSkyHeightForRemovedBlock(const BlockInfo& removedBlockInfo);
 	void SetFarthestEastBlock(const Vector3& playerPos);
 	char GetSkyLightLevelForChunkCoords(const IntVector2& chunkCoords);
 	void CalcOutdoorLightLevel();
-	Vector3 CalcEastNeighborCenterWorldCoords(const IntVector2& chunkCoords);
-	Vector3 CalcWestNeighborCenterWorldCoords(const IntVector2& chunkCoords);
-	Vector3 CalcNorthNeighborCenterWorldCoords(const IntVector2& chunkCoords);
-	Vector3 CalcSouthNeighborCenterWorldCoords(const IntVector2& chunkCoords);
+	Vector3 CalcChunkCenterWorldCoords(const IntVector2& chunkCoords);
 
+	void AddDirtyLightingBlock(Chunk* chunk, int blockIndex);
+	bool IsChunkLightSettled(const Chunk* chunk) const;
+	void RecordPendingBorderLight(Chunk* chunk, LightingBorder border);
+	void ReconcileBorderLight(Chunk* chunk, LightingBorder border);
+	void ReconcileBorderBlock(Chunk* chunk, int blockIndex, int neighborPackedLight, LightingBorder border, int borderIndex);
+	void AssignChunkSlot(Chunk* chunk);
+	void ReleaseChunkSlot(Chunk* chunk);
 	void SetBlockNeighborsDirty(BlockInfo* blockInfo);
+	void SetBlockMeshDirty(const BlockInfo& blockInfo);
+	void SetBlockLightDirty(const BlockInfo& blockInfo);
 };
\ No newline at end of file